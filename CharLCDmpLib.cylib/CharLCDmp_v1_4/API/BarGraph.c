@@ -147,6 +147,118 @@ void `$INSTANCE_NAME`_LoadCustomFonts(uint8 const customData[]) `=ReentrantKeil(
         }
     }
 
+
+
+    /*******************************************************************************
+    * Function Name: `$INSTANCE_NAME`_InitHorizontalBG
+    ********************************************************************************
+    *
+    * Summary:
+    *  Sets up a horizontal bar graph that is drawn in the frame buffer and
+    *  updated incrementally by UpdateHorizontalBG(). Draws it empty.
+    *
+    * Parameters:
+    *  barGraph:       state of the bar graph, kept by the caller.
+    *  row:            The row in which the bar graph starts.
+    *  column:         The column in which the bar graph starts.
+    *  maxCharacters:  The max length of the graph in whole characters.
+    *
+    * Return:
+    *  void.
+    *
+    *******************************************************************************/
+    void `$INSTANCE_NAME`_InitHorizontalBG(`$INSTANCE_NAME`_BAR_GRAPH_STRUCT * barGraph, uint8 row, uint8 column,
+                                uint8 maxCharacters) `=ReentrantKeil($INSTANCE_NAME . "_InitHorizontalBG")`
+    {
+        uint8 count8;
+
+        barGraph->row = row;
+        barGraph->column = column;
+        barGraph->maxCharacters = maxCharacters;
+        barGraph->value = 0u;
+
+        `$INSTANCE_NAME`_BufPosition(row, column);
+        for(count8 = 0u; count8 < maxCharacters; count8++)
+        {
+            `$INSTANCE_NAME`_BufPutChar((char8) `$INSTANCE_NAME`_CUSTOM_0);
+        }
+    }
+
+
+    /*******************************************************************************
+    * Function Name: `$INSTANCE_NAME`_UpdateHorizontalBG
+    ********************************************************************************
+    *
+    * Summary:
+    *  Moves a horizontal bar graph to a new length. Only the cells between the
+    *  old and the new end of the bar are rewritten, as one run of adjacent
+    *  frame buffer cells, so a small move costs one or two data writes at the
+    *  next Flush() instead of a full redraw.
+    *
+    * Parameters:
+    *  barGraph:  bar graph set up with InitHorizontalBG().
+    *  value:     The new length of the graph in pixels, clipped to the graph.
+    *
+    * Return:
+    *  void.
+    *
+    *******************************************************************************/
+    void `$INSTANCE_NAME`_UpdateHorizontalBG(`$INSTANCE_NAME`_BAR_GRAPH_STRUCT * barGraph, uint8 value) \
+                                                            `=ReentrantKeil($INSTANCE_NAME . "_UpdateHorizontalBG")`
+    {
+        uint16 maxPixels = (uint16) barGraph->maxCharacters * `$INSTANCE_NAME`_CHARACTER_WIDTH;
+        uint8 fullChars;
+        uint8 cell;
+        uint8 lastCell;
+
+        if(value > maxPixels)
+        {
+            value = (uint8) maxPixels;
+        }
+
+        if(value != barGraph->value)
+        {
+            fullChars = value / `$INSTANCE_NAME`_CHARACTER_WIDTH;
+
+            /* Cells from the shorter end to the longer end of the two bars */
+            if(value < barGraph->value)
+            {
+                cell = fullChars;
+                lastCell = barGraph->value / `$INSTANCE_NAME`_CHARACTER_WIDTH;
+            }
+            else
+            {
+                cell = barGraph->value / `$INSTANCE_NAME`_CHARACTER_WIDTH;
+                lastCell = fullChars;
+            }
+
+            if(lastCell >= barGraph->maxCharacters)
+            {
+                lastCell = barGraph->maxCharacters - 1u;
+            }
+
+            `$INSTANCE_NAME`_BufPosition(barGraph->row, barGraph->column + cell);
+            for(; cell <= lastCell; cell++)
+            {
+                if(cell < fullChars)
+                {
+                    `$INSTANCE_NAME`_BufPutChar((char8) `$INSTANCE_NAME`_CUSTOM_5);
+                }
+                else if(cell == fullChars)
+                {
+                    /* Partial cell, CUSTOM_0 to CUSTOM_4 */
+                    `$INSTANCE_NAME`_BufPutChar((char8)(value % `$INSTANCE_NAME`_CHARACTER_WIDTH));
+                }
+                else
+                {
+                    `$INSTANCE_NAME`_BufPutChar((char8) `$INSTANCE_NAME`_CUSTOM_0);
+                }
+            }
+
+            barGraph->value = value;
+        }
+    }
+
 #endif /* `$INSTANCE_NAME`_CUSTOM_CHAR_SET == `$INSTANCE_NAME`_HORIZONTAL_BG */
 
 
@@ -239,6 +351,124 @@ void `$INSTANCE_NAME`_LoadCustomFonts(uint8 const customData[]) `=ReentrantKeil(
         }
     }
 
+
+
+    /*******************************************************************************
+    * Function Name: `$INSTANCE_NAME`_InitVerticalBG
+    ********************************************************************************
+    *
+    * Summary:
+    *  Sets up a vertical bar graph that is drawn in the frame buffer and
+    *  updated incrementally by UpdateVerticalBG(). Draws it empty.
+    *
+    * Parameters:
+    *  barGraph:       state of the bar graph, kept by the caller.
+    *  row:            The row in which the bar graph starts (its bottom).
+    *  column:         The column in which the bar graph starts.
+    *  maxCharacters:  The max height of the graph in whole characters.
+    *
+    * Return:
+    *  void.
+    *
+    *******************************************************************************/
+    void `$INSTANCE_NAME`_InitVerticalBG(`$INSTANCE_NAME`_BAR_GRAPH_STRUCT * barGraph, uint8 row, uint8 column,
+                              uint8 maxCharacters) `=ReentrantKeil($INSTANCE_NAME . "_InitVerticalBG")`
+    {
+        uint8 count8;
+
+        /* The graph cannot grow above the top row */
+        if(maxCharacters > (row + 1u))
+        {
+            maxCharacters = row + 1u;
+        }
+
+        barGraph->row = row;
+        barGraph->column = column;
+        barGraph->maxCharacters = maxCharacters;
+        barGraph->value = 0u;
+
+        for(count8 = 0u; count8 < maxCharacters; count8++)
+        {
+            `$INSTANCE_NAME`_BufPosPutChar(row - count8, column, (char8) ' ');
+        }
+    }
+
+
+    /*******************************************************************************
+    * Function Name: `$INSTANCE_NAME`_UpdateVerticalBG
+    ********************************************************************************
+    *
+    * Summary:
+    *  Moves a vertical bar graph to a new height. Only the cells between the
+    *  old and the new top of the bar are rewritten in the frame buffer.
+    *
+    * Parameters:
+    *  barGraph:  bar graph set up with InitVerticalBG().
+    *  value:     The new height of the graph in pixels, clipped to the graph.
+    *
+    * Return:
+    *  void.
+    *
+    *******************************************************************************/
+    void `$INSTANCE_NAME`_UpdateVerticalBG(`$INSTANCE_NAME`_BAR_GRAPH_STRUCT * barGraph, uint8 value) \
+                                                            `=ReentrantKeil($INSTANCE_NAME . "_UpdateVerticalBG")`
+    {
+        uint16 maxPixels = (uint16) barGraph->maxCharacters * `$INSTANCE_NAME`_CHARACTER_HEIGHT;
+        uint8 fullChars;
+        uint8 remainingPixels;
+        uint8 cell;
+        uint8 lastCell;
+        char8 character;
+
+        if(value > maxPixels)
+        {
+            value = (uint8) maxPixels;
+        }
+
+        if(value != barGraph->value)
+        {
+            fullChars = value / `$INSTANCE_NAME`_CHARACTER_HEIGHT;
+            remainingPixels = value % `$INSTANCE_NAME`_CHARACTER_HEIGHT;
+
+            /* Cells from the lower top to the higher top of the two bars */
+            if(value < barGraph->value)
+            {
+                cell = fullChars;
+                lastCell = barGraph->value / `$INSTANCE_NAME`_CHARACTER_HEIGHT;
+            }
+            else
+            {
+                cell = barGraph->value / `$INSTANCE_NAME`_CHARACTER_HEIGHT;
+                lastCell = fullChars;
+            }
+
+            if(lastCell >= barGraph->maxCharacters)
+            {
+                lastCell = barGraph->maxCharacters - 1u;
+            }
+
+            for(; cell <= lastCell; cell++)
+            {
+                if(cell < fullChars)
+                {
+                    character = (char8) `$INSTANCE_NAME`_CUSTOM_7;
+                }
+                else if((cell == fullChars) && (remainingPixels != 0u))
+                {
+                    character = (char8)(remainingPixels - 1u);
+                }
+                else
+                {
+                    character = (char8) ' ';
+                }
+
+                `$INSTANCE_NAME`_BufPosPutChar(barGraph->row - cell, barGraph->column, character);
+            }
+
+            barGraph->value = value;
+        }
+    }
+
 #endif /* `$INSTANCE_NAME`_CUSTOM_CHAR_SET == `$INSTANCE_NAME`_VERTICAL_BG */
 
 
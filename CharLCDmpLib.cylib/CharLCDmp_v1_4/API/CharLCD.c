@@ -20,6 +20,9 @@
 
 static void `$INSTANCE_NAME`_WrDatNib(uint8 nibble) `=ReentrantKeil($INSTANCE_NAME . "_WrDatNib")`;
 static void `$INSTANCE_NAME`_WrCntrlNib(uint8 nibble) `=ReentrantKeil($INSTANCE_NAME . "_WrCntrlNib")`;
+static void `$INSTANCE_NAME`_WrBus(uint8 bus) `=ReentrantKeil($INSTANCE_NAME . "_WrBus")`;
+static void `$INSTANCE_NAME`_BufInit(void) `=ReentrantKeil($INSTANCE_NAME . "_BufInit")`;
+static void `$INSTANCE_NAME`_InitTick(void) `=ReentrantKeil($INSTANCE_NAME . "_InitTick")`;
 
 /* Stores the state of conponent. Indicates wherewer component is 
 * in enable state or not.
@@ -28,6 +31,87 @@ uint8 `$INSTANCE_NAME`_enableState = 0u;
 
 uint8 `$INSTANCE_NAME`_initVar = 0u;
 
+/* Shadow frame buffer. frameBuf holds what the application wants to show,
+* glassBuf holds what has already been clocked out to the LCD module.
+*/
+static char8 `$INSTANCE_NAME`_frameBuf[`$INSTANCE_NAME`_BUF_ROWS][`$INSTANCE_NAME`_BUF_COLUMNS];
+static char8 `$INSTANCE_NAME`_glassBuf[`$INSTANCE_NAME`_BUF_ROWS][`$INSTANCE_NAME`_BUF_COLUMNS];
+
+/* One bit per column: cells changed since the last Flush (pendingMask) and
+* cells handed to the flush state machine (dirtyMask).
+*/
+static uint32 `$INSTANCE_NAME`_pendingMask[`$INSTANCE_NAME`_BUF_ROWS];
+static volatile uint32 `$INSTANCE_NAME`_dirtyMask[`$INSTANCE_NAME`_BUF_ROWS];
+
+/* Frame buffer cursor */
+static uint8 `$INSTANCE_NAME`_bufRow = 0u;
+static uint8 `$INSTANCE_NAME`_bufColumn = 0u;
+
+/* Flush state machine. ddramAddr is the Set DDRAM Address command matching
+* the module's address counter, or 0 when unknown.
+*/
+static volatile uint8 `$INSTANCE_NAME`_flushState = `$INSTANCE_NAME`_FLUSH_IDLE;
+static volatile uint16 `$INSTANCE_NAME`_waitTicks = 0u;
+static uint8 `$INSTANCE_NAME`_flushByte = 0u;
+static uint8 `$INSTANCE_NAME`_flushIsData = 0u;
+static uint16 `$INSTANCE_NAME`_flushWait = 0u;
+static volatile uint8 `$INSTANCE_NAME`_ddramAddr = 0u;
+
+static uint8 const CYCODE `$INSTANCE_NAME`_rowStart[4u] =
+{
+    `$INSTANCE_NAME`_ROW_0_START, `$INSTANCE_NAME`_ROW_1_START,
+    `$INSTANCE_NAME`_ROW_2_START, `$INSTANCE_NAME`_ROW_3_START
+};
+
+/* Background initialization (StartBackground). initStep indexes initSequence,
+* then the custom font bytes; initBusy is cleared once the sequence is done.
+*/
+typedef struct
+{
+    uint8 value;        /* nibble or command byte */
+    uint8 isByte;       /* 0: single nibble, 1: command byte as two nibbles */
+    uint16 waitTicks;   /* ticks to wait after it */
+} `$INSTANCE_NAME`_INIT_STEP;
+
+/* Init() waits CMD_DELAY_US and 5 ms after the last command, and
+* LoadCustomFonts() another 5 ms in IsReady() before it sets the CGRAM address
+*/
+#if(`$INSTANCE_NAME`_CUSTOM_CHAR_SET != `$INSTANCE_NAME`_NONE)
+    #define `$INSTANCE_NAME`_INIT_LAST_WAIT_TICKS    (`$INSTANCE_NAME`_US_TICKS(`$INSTANCE_NAME`_CMD_DELAY_US + 10000u))
+#else
+    #define `$INSTANCE_NAME`_INIT_LAST_WAIT_TICKS    (`$INSTANCE_NAME`_US_TICKS(`$INSTANCE_NAME`_CMD_DELAY_US + 5000u))
+#endif /* `$INSTANCE_NAME`_CUSTOM_CHAR_SET != `$INSTANCE_NAME`_NONE */
+
+/* Same sequence and delays as Init() */
+static `$INSTANCE_NAME`_INIT_STEP const CYCODE `$INSTANCE_NAME`_initSequence[] =
+{
+    {`$INSTANCE_NAME`_DISPLAY_8_BIT_INIT,    0u, `$INSTANCE_NAME`_MS_TICKS(5u)},
+    {`$INSTANCE_NAME`_DISPLAY_8_BIT_INIT,    0u, `$INSTANCE_NAME`_MS_TICKS(15u)},
+    {`$INSTANCE_NAME`_DISPLAY_8_BIT_INIT,    0u, `$INSTANCE_NAME`_MS_TICKS(1u)},
+    {`$INSTANCE_NAME`_DISPLAY_4_BIT_INIT,    0u, `$INSTANCE_NAME`_MS_TICKS(5u)},
+    {`$INSTANCE_NAME`_CURSOR_AUTO_INCR_ON,   1u, `$INSTANCE_NAME`_CMD_WAIT_TICKS},
+    {`$INSTANCE_NAME`_DISPLAY_CURSOR_ON,     1u, `$INSTANCE_NAME`_CMD_WAIT_TICKS},
+    {`$INSTANCE_NAME`_DISPLAY_2_LINES_5x10,  1u, `$INSTANCE_NAME`_CMD_WAIT_TICKS},
+    {`$INSTANCE_NAME`_DISPLAY_CURSOR_OFF,    1u, `$INSTANCE_NAME`_CMD_WAIT_TICKS},
+    {`$INSTANCE_NAME`_CLEAR_DISPLAY,         1u, `$INSTANCE_NAME`_CMD_WAIT_TICKS},
+    {`$INSTANCE_NAME`_DISPLAY_ON_CURSOR_OFF, 1u, `$INSTANCE_NAME`_CMD_WAIT_TICKS},
+    {`$INSTANCE_NAME`_RESET_CURSOR_POSITION, 1u, `$INSTANCE_NAME`_INIT_LAST_WAIT_TICKS},
+#if(`$INSTANCE_NAME`_CUSTOM_CHAR_SET != `$INSTANCE_NAME`_NONE)
+    {`$INSTANCE_NAME`_CGRAM_0,               1u, `$INSTANCE_NAME`_CMD_WAIT_TICKS},
+#endif /* `$INSTANCE_NAME`_CUSTOM_CHAR_SET != `$INSTANCE_NAME`_NONE */
+};
+
+#define `$INSTANCE_NAME`_INIT_SEQUENCE_LEN   (sizeof(`$INSTANCE_NAME`_initSequence) / sizeof(`$INSTANCE_NAME`_initSequence[0u]))
+
+#if(`$INSTANCE_NAME`_CUSTOM_CHAR_SET != `$INSTANCE_NAME`_NONE)
+    #define `$INSTANCE_NAME`_INIT_STEPS      (`$INSTANCE_NAME`_INIT_SEQUENCE_LEN + `$INSTANCE_NAME`_CUSTOM_CHAR_SET_LEN)
+#else
+    #define `$INSTANCE_NAME`_INIT_STEPS      (`$INSTANCE_NAME`_INIT_SEQUENCE_LEN)
+#endif /* `$INSTANCE_NAME`_CUSTOM_CHAR_SET != `$INSTANCE_NAME`_NONE */
+
+static volatile uint8 `$INSTANCE_NAME`_initBusy = 0u;
+static uint8 `$INSTANCE_NAME`_initStep = 0u;
+
 
 /*******************************************************************************
 * Function Name: `$INSTANCE_NAME`_Init
@@ -75,6 +159,9 @@ void `$INSTANCE_NAME`_Init(void) `=ReentrantKeil($INSTANCE_NAME . "_Init")`
     `$INSTANCE_NAME`_WriteControl(`$INSTANCE_NAME`_RESET_CURSOR_POSITION);  /* Set Cursor to 0,0 */
     CyDelay(5u);
 
+    /* Display is now blank, so is the frame buffer */
+    `$INSTANCE_NAME`_BufInit();
+
     #if(`$INSTANCE_NAME`_CUSTOM_CHAR_SET != `$INSTANCE_NAME`_NONE)
         `$INSTANCE_NAME`_LoadCustomFonts(`$INSTANCE_NAME`_customFonts);
     #endif /* `$INSTANCE_NAME`_CUSTOM_CHAR_SET != `$INSTANCE_NAME`_NONE */
@@ -149,6 +236,51 @@ void `$INSTANCE_NAME`_Start(void) `=ReentrantKeil($INSTANCE_NAME . "_Start")`
 }
 
 
+/*******************************************************************************
+* Function Name: `$INSTANCE_NAME`_StartBackground
+********************************************************************************
+*
+* Summary:
+*  Same as Start(), but returns at once: the initialization sequence,
+*  including its power-up delay and the custom fonts, is clocked out by
+*  FlushTick(). The frame buffer API can be used straight away; what is
+*  written is shown once the display is initialized. The blocking API must
+*  not be used while IsFlushing() returns non-zero.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None.
+*
+* Reentrant:
+*  No.
+*
+*******************************************************************************/
+void `$INSTANCE_NAME`_StartBackground(void) `=ReentrantKeil($INSTANCE_NAME . "_StartBackground")`
+{
+    uint8 interruptState;
+
+    if(`$INSTANCE_NAME`_initVar == 0u)
+    {
+        interruptState = CyEnterCriticalSection();
+
+        /* Display will be blank once the sequence has run */
+        `$INSTANCE_NAME`_BufInit();
+        `$INSTANCE_NAME`_initStep = 0u;
+        `$INSTANCE_NAME`_waitTicks = `$INSTANCE_NAME`_MS_TICKS(40u);
+        `$INSTANCE_NAME`_initBusy = 1u;
+
+        CyExitCriticalSection(interruptState);
+
+        `$INSTANCE_NAME`_initVar = 1u;
+    }
+
+    /* The sequence ends with the display on */
+    `$INSTANCE_NAME`_enableState = 1u;
+}
+
+
 /*******************************************************************************
 * Function Name: `$INSTANCE_NAME`_Stop
 ********************************************************************************
@@ -286,6 +418,9 @@ void `$INSTANCE_NAME`_WriteData(uint8 dByte) `=ReentrantKeil($INSTANCE_NAME . "_
 {
     uint8 nibble;
 
+    /* Blocking writes move the address counter behind the flush state machine */
+    `$INSTANCE_NAME`_ddramAddr = 0u;
+
     /* Write high nibble */
 	nibble = dByte >> `$INSTANCE_NAME`_NIBBLE_SHIFT;
     `$INSTANCE_NAME`_WrDatNib(nibble);
@@ -319,6 +454,9 @@ void `$INSTANCE_NAME`_WriteControl(uint8 cByte) `=ReentrantKeil($INSTANCE_NAME .
 {
     uint8 nibble;
 
+    /* Blocking writes move the address counter behind the flush state machine */
+    `$INSTANCE_NAME`_ddramAddr = 0u;
+
     /* WrCntrlNib(High Nibble) */
 	 nibble = cByte >> `$INSTANCE_NAME`_NIBBLE_SHIFT;
     `$INSTANCE_NAME`_WrCntrlNib(nibble);
@@ -375,24 +513,8 @@ void `$INSTANCE_NAME`_IsReady(void) `=ReentrantKeil($INSTANCE_NAME . "_IsReady")
 *******************************************************************************/
 static void `$INSTANCE_NAME`_WrDatNib(uint8 nibble) `=ReentrantKeil($INSTANCE_NAME . "_WrDatNib")`
 {
-
-    /* RS shoul be low to select data register */
-    `$INSTANCE_NAME`_CNTL_REG |= `$INSTANCE_NAME`_RS;
-    /* Reset RW for write operation */
- //   `$INSTANCE_NAME`_CNTL_REG &= ~`$INSTANCE_NAME`_RW;
-
-    /* Two following lines of code will provide us with 40ns delay */
-    /* Clear data pins */
-    `$INSTANCE_NAME`_CNTL_REG &= ~`$INSTANCE_NAME`_DATA_MASK;
-
-    /* Write in data, bring E high*/
-    `$INSTANCE_NAME`_CNTL_REG |= (`$INSTANCE_NAME`_E | nibble);
-
-    /* Minimum of 230 ns delay */
-    CyDelayUs(`$INSTANCE_NAME`_E_SETUP_US );
-
-    `$INSTANCE_NAME`_CNTL_REG &= ~`$INSTANCE_NAME`_E;
-	
+    /* RS high selects the data register */
+    `$INSTANCE_NAME`_WrBus(`$INSTANCE_NAME`_RS | (nibble & `$INSTANCE_NAME`_DATA_MASK));
 }
 
 
@@ -413,23 +535,438 @@ static void `$INSTANCE_NAME`_WrDatNib(uint8 nibble) `=ReentrantKeil($INSTANCE_NA
 *******************************************************************************/
 static void `$INSTANCE_NAME`_WrCntrlNib(uint8 nibble) `=ReentrantKeil($INSTANCE_NAME . "_WrCntrlNib")`
 {
-	
-	/* RS and RW shoul be low to select instruction register and  write operation respectively */
-//    `$INSTANCE_NAME`_CNTL_REG &= ~(`$INSTANCE_NAME`_RS | `$INSTANCE_NAME`_RW);
-    `$INSTANCE_NAME`_CNTL_REG &= ~(`$INSTANCE_NAME`_RS );
+    /* RS low selects the instruction register */
+    `$INSTANCE_NAME`_WrBus(nibble & `$INSTANCE_NAME`_DATA_MASK);
+}
+
+
+/*******************************************************************************
+*  Function Name: `$INSTANCE_NAME`_WrBus
+********************************************************************************
+*
+* Summary:
+*  Clocks one nibble into the LCD module with three whole-register stores
+*  and no read back: RS and data with E low, the same with E high for the
+*  pulse width, then E low again, which latches the nibble. The delays are
+*  bus clock cycles and only inserted where a store is not long enough.
+*  The other control register bits are driven low.
+*
+* Parameters:
+*  bus:  control register value with RS and the data bits, E clear.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+static void `$INSTANCE_NAME`_WrBus(uint8 bus) `=ReentrantKeil($INSTANCE_NAME . "_WrBus")`
+{
+    `$INSTANCE_NAME`_CNTL_REG = bus;
+
+#if(`$INSTANCE_NAME`_ADDRESS_SETUP_CYCLES > `$INSTANCE_NAME`_STORE_CYCLES)
+    CyDelayCycles(`$INSTANCE_NAME`_ADDRESS_SETUP_CYCLES);
+#endif /* `$INSTANCE_NAME`_ADDRESS_SETUP_CYCLES > `$INSTANCE_NAME`_STORE_CYCLES */
+
+    `$INSTANCE_NAME`_CNTL_REG = bus | `$INSTANCE_NAME`_E;
+
+#if(`$INSTANCE_NAME`_E_PULSE_CYCLES > `$INSTANCE_NAME`_STORE_CYCLES)
+    CyDelayCycles(`$INSTANCE_NAME`_E_PULSE_CYCLES);
+#endif /* `$INSTANCE_NAME`_E_PULSE_CYCLES > `$INSTANCE_NAME`_STORE_CYCLES */
+
+    `$INSTANCE_NAME`_CNTL_REG = bus;
+}
+
+
+/*******************************************************************************
+*  Function Name: `$INSTANCE_NAME`_BufInit
+********************************************************************************
+*
+* Summary:
+*  Marks the frame buffer and the glass as blank and stops any flush in
+*  progress. Called by Init() right after the display has been cleared.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+static void `$INSTANCE_NAME`_BufInit(void) `=ReentrantKeil($INSTANCE_NAME . "_BufInit")`
+{
+    uint8 row;
+    uint8 column;
+
+    for(row = 0u; row < `$INSTANCE_NAME`_BUF_ROWS; row++)
+    {
+        for(column = 0u; column < `$INSTANCE_NAME`_BUF_COLUMNS; column++)
+        {
+            `$INSTANCE_NAME`_frameBuf[row][column] = (char8) ' ';
+            `$INSTANCE_NAME`_glassBuf[row][column] = (char8) ' ';
+        }
+        `$INSTANCE_NAME`_pendingMask[row] = 0u;
+        `$INSTANCE_NAME`_dirtyMask[row] = 0u;
+    }
+
+    `$INSTANCE_NAME`_bufRow = 0u;
+    `$INSTANCE_NAME`_bufColumn = 0u;
+    `$INSTANCE_NAME`_flushState = `$INSTANCE_NAME`_FLUSH_IDLE;
+    `$INSTANCE_NAME`_waitTicks = 0u;
+    `$INSTANCE_NAME`_ddramAddr = `$INSTANCE_NAME`_ROW_0_START;
+}
+
+
+/*******************************************************************************
+*  Function Name: `$INSTANCE_NAME`_BufClear
+********************************************************************************
+*
+* Summary:
+*  Fills the frame buffer with spaces and moves the buffer cursor to 0,0.
+*  Takes effect on the glass at the next Flush().
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void `$INSTANCE_NAME`_BufClear(void) `=ReentrantKeil($INSTANCE_NAME . "_BufClear")`
+{
+    uint8 row;
+
+    for(row = 0u; row < `$INSTANCE_NAME`_BUF_ROWS; row++)
+    {
+        `$INSTANCE_NAME`_BufPosition(row, 0u);
+        while(`$INSTANCE_NAME`_bufColumn < `$INSTANCE_NAME`_BUF_COLUMNS)
+        {
+            `$INSTANCE_NAME`_BufPutChar((char8) ' ');
+        }
+    }
+
+    `$INSTANCE_NAME`_BufPosition(0u, 0u);
+}
+
+
+/*******************************************************************************
+*  Function Name: `$INSTANCE_NAME`_BufPosition
+********************************************************************************
+*
+* Summary:
+*  Moves the frame buffer cursor. Nothing is sent to the LCD module.
+*
+* Parameters:
+*  row:     Row of the frame buffer to be written
+*  column:  Column of the frame buffer to be written
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void `$INSTANCE_NAME`_BufPosition(uint8 row, uint8 column) `=ReentrantKeil($INSTANCE_NAME . "_BufPosition")`
+{
+    `$INSTANCE_NAME`_bufRow = row;
+    `$INSTANCE_NAME`_bufColumn = column;
+}
+
+
+/*******************************************************************************
+*  Function Name: `$INSTANCE_NAME`_BufPutChar
+********************************************************************************
+*
+* Summary:
+*  Writes a character at the frame buffer cursor and advances the cursor.
+*  The cell is only marked for flushing if it differs from the glass.
+*  Characters outside the frame buffer are discarded.
+*
+* Parameters:
+*  character:  character to be written
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void `$INSTANCE_NAME`_BufPutChar(char8 character) `=ReentrantKeil($INSTANCE_NAME . "_BufPutChar")`
+{
+    uint8 row = `$INSTANCE_NAME`_bufRow;
+    uint8 column = `$INSTANCE_NAME`_bufColumn;
+
+    if((row < `$INSTANCE_NAME`_BUF_ROWS) && (column < `$INSTANCE_NAME`_BUF_COLUMNS))
+    {
+        `$INSTANCE_NAME`_frameBuf[row][column] = character;
+
+        if(`$INSTANCE_NAME`_glassBuf[row][column] != character)
+        {
+            `$INSTANCE_NAME`_pendingMask[row] |= ((uint32) 1u << column);
+        }
+
+        `$INSTANCE_NAME`_bufColumn++;
+    }
+}
+
+
+/*******************************************************************************
+*  Function Name: `$INSTANCE_NAME`_BufPrintString
+********************************************************************************
+*
+* Summary:
+*  Writes a zero terminated string at the frame buffer cursor.
+*
+* Parameters:
+*  string:  pointer to head of char8 array to be written
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void `$INSTANCE_NAME`_BufPrintString(char8 const string[]) `=ReentrantKeil($INSTANCE_NAME . "_BufPrintString")`
+{
+    uint8 indexU8 = 1u;
+    char8 current = *string;
+
+    /* Until null is reached, buffer next character */
+    while((char8) '\0' != current)
+    {
+        `$INSTANCE_NAME`_BufPutChar(current);
+        current = string[indexU8];
+        indexU8++;
+    }
+}
+
+
+/*******************************************************************************
+*  Function Name: `$INSTANCE_NAME`_Flush
+********************************************************************************
+*
+* Summary:
+*  Hands every cell changed since the last call to the flush state machine.
+*  Returns immediately; the cells are clocked out by FlushTick().
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void `$INSTANCE_NAME`_Flush(void) `=ReentrantKeil($INSTANCE_NAME . "_Flush")`
+{
+    uint8 row;
+    uint8 interruptState;
+
+    interruptState = CyEnterCriticalSection();
+
+    for(row = 0u; row < `$INSTANCE_NAME`_BUF_ROWS; row++)
+    {
+        `$INSTANCE_NAME`_dirtyMask[row] |= `$INSTANCE_NAME`_pendingMask[row];
+        `$INSTANCE_NAME`_pendingMask[row] = 0u;
+    }
+
+    CyExitCriticalSection(interruptState);
+}
+
+
+/*******************************************************************************
+*  Function Name: `$INSTANCE_NAME`_IsFlushing
+********************************************************************************
+*
+* Summary:
+*  Reports whether the flush state machine still owns the LCD bus.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  Non-zero while cells remain to be clocked out.
+*
+* Note:
+*  The blocking API (Position, PrintString, PutChar ...) must not be used
+*  while this returns non-zero.
+*
+*******************************************************************************/
+uint8 `$INSTANCE_NAME`_IsFlushing(void) `=ReentrantKeil($INSTANCE_NAME . "_IsFlushing")`
+{
+    uint8 row;
+    uint8 busy;
+
+    busy = ((`$INSTANCE_NAME`_flushState != `$INSTANCE_NAME`_FLUSH_IDLE) ||
+            (`$INSTANCE_NAME`_waitTicks != 0u) || (`$INSTANCE_NAME`_initBusy != 0u)) ? 1u : 0u;
+
+    for(row = 0u; row < `$INSTANCE_NAME`_BUF_ROWS; row++)
+    {
+        if(`$INSTANCE_NAME`_dirtyMask[row] != 0u)
+        {
+            busy = 1u;
+        }
+    }
 
-    /* Two following lines of code will give provide ua with 40ns delay */
-    /* Clear data pins */
-    `$INSTANCE_NAME`_CNTL_REG &= ~`$INSTANCE_NAME`_DATA_MASK;
+    return busy;
+}
+
+
+/*******************************************************************************
+*  Function Name: `$INSTANCE_NAME`_FlushTick
+********************************************************************************
+*
+* Summary:
+*  Advances the flush state machine by one step. Must be called every
+*  `$INSTANCE_NAME`_FLUSH_TICK_US, typically from a timer interrupt. Each call
+*  either waits out a byte delay or clocks out one nibble, so no call blocks
+*  for longer than one E pulse.
+*
+*  After StartBackground() the initialization sequence is sent first, with
+*  its delays counted in ticks.
+*
+*  Dirty cells are sent in row order. A Set DDRAM Address command is only
+*  sent when the next dirty cell does not follow the previous one, so a run
+*  of adjacent changes goes out as one auto-increment burst.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void `$INSTANCE_NAME`_FlushTick(void) `=ReentrantKeil($INSTANCE_NAME . "_FlushTick")`
+{
+    uint8 row;
+    uint8 column;
+    uint8 address;
+    uint32 mask;
+
+    if(`$INSTANCE_NAME`_waitTicks != 0u)
+    {
+        `$INSTANCE_NAME`_waitTicks--;
+    }
+    else if(`$INSTANCE_NAME`_flushState == `$INSTANCE_NAME`_FLUSH_LOW_NIBBLE)
+    {
+        if(`$INSTANCE_NAME`_flushIsData != 0u)
+        {
+            `$INSTANCE_NAME`_WrDatNib(`$INSTANCE_NAME`_flushByte & `$INSTANCE_NAME`_NIBBLE_MASK);
+        }
+        else
+        {
+            `$INSTANCE_NAME`_WrCntrlNib(`$INSTANCE_NAME`_flushByte & `$INSTANCE_NAME`_NIBBLE_MASK);
+        }
+        `$INSTANCE_NAME`_waitTicks = `$INSTANCE_NAME`_flushWait;
+        `$INSTANCE_NAME`_flushState = `$INSTANCE_NAME`_FLUSH_IDLE;
+    }
+    else if(`$INSTANCE_NAME`_initBusy != 0u)
+    {
+        `$INSTANCE_NAME`_InitTick();
+    }
+    else
+    {
+        for(row = 0u; row < `$INSTANCE_NAME`_BUF_ROWS; row++)
+        {
+            mask = `$INSTANCE_NAME`_dirtyMask[row];
+
+            for(column = 0u; mask != 0u; column++)
+            {
+                if((mask & 1u) != 0u)
+                {
+                    if(`$INSTANCE_NAME`_frameBuf[row][column] == `$INSTANCE_NAME`_glassBuf[row][column])
+                    {
+                        /* Changed back before it was sent, nothing to do */
+                        `$INSTANCE_NAME`_dirtyMask[row] &= ~((uint32) 1u << column);
+                    }
+                    else
+                    {
+                        break;
+                    }
+                }
+                mask >>= 1u;
+            }
+
+            if(mask != 0u)
+            {
+                address = `$INSTANCE_NAME`_rowStart[row] + column;
+
+                if(address != `$INSTANCE_NAME`_ddramAddr)
+                {
+                    /* Not adjacent to the last cell sent, move the address counter */
+                    `$INSTANCE_NAME`_flushByte = address;
+                    `$INSTANCE_NAME`_flushIsData = 0u;
+                    `$INSTANCE_NAME`_flushWait = `$INSTANCE_NAME`_ADDR_WAIT_TICKS;
+                    `$INSTANCE_NAME`_ddramAddr = address;
+                    `$INSTANCE_NAME`_WrCntrlNib(address >> `$INSTANCE_NAME`_NIBBLE_SHIFT);
+                }
+                else
+                {
+                    `$INSTANCE_NAME`_flushByte = (uint8) `$INSTANCE_NAME`_frameBuf[row][column];
+                    `$INSTANCE_NAME`_flushIsData = 1u;
+                    `$INSTANCE_NAME`_flushWait = `$INSTANCE_NAME`_DATA_WAIT_TICKS;
+                    `$INSTANCE_NAME`_glassBuf[row][column] = (char8) `$INSTANCE_NAME`_flushByte;
+                    `$INSTANCE_NAME`_dirtyMask[row] &= ~((uint32) 1u << column);
+                    `$INSTANCE_NAME`_ddramAddr++;
+                    `$INSTANCE_NAME`_WrDatNib(`$INSTANCE_NAME`_flushByte >> `$INSTANCE_NAME`_NIBBLE_SHIFT);
+                }
+
+                `$INSTANCE_NAME`_flushState = `$INSTANCE_NAME`_FLUSH_LOW_NIBBLE;
+                break;
+            }
+        }
+    }
+}
 
-    /* Write control data and set enable signal */
-    `$INSTANCE_NAME`_CNTL_REG |= (`$INSTANCE_NAME`_E | nibble);
 
-    /* Minimum of 230 ns delay */
-    CyDelayUs(`$INSTANCE_NAME`_E_SETUP_US );
-    
+/*******************************************************************************
+*  Function Name: `$INSTANCE_NAME`_InitTick
+********************************************************************************
+*
+* Summary:
+*  Sends the next step of the background initialization: one nibble of the
+*  sequence, the high nibble of a command or font byte (the low nibble
+*  follows on the next tick), or, at the end, releases the display to the
+*  frame buffer flush. Called by FlushTick().
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+static void `$INSTANCE_NAME`_InitTick(void) `=ReentrantKeil($INSTANCE_NAME . "_InitTick")`
+{
+    if(`$INSTANCE_NAME`_initStep < `$INSTANCE_NAME`_INIT_SEQUENCE_LEN)
+    {
+        `$INSTANCE_NAME`_flushByte = `$INSTANCE_NAME`_initSequence[`$INSTANCE_NAME`_initStep].value;
 
-    `$INSTANCE_NAME`_CNTL_REG &= ~`$INSTANCE_NAME`_E;
+        if(`$INSTANCE_NAME`_initSequence[`$INSTANCE_NAME`_initStep].isByte != 0u)
+        {
+            `$INSTANCE_NAME`_flushIsData = 0u;
+            `$INSTANCE_NAME`_flushWait = `$INSTANCE_NAME`_initSequence[`$INSTANCE_NAME`_initStep].waitTicks;
+            `$INSTANCE_NAME`_WrCntrlNib(`$INSTANCE_NAME`_flushByte >> `$INSTANCE_NAME`_NIBBLE_SHIFT);
+            `$INSTANCE_NAME`_flushState = `$INSTANCE_NAME`_FLUSH_LOW_NIBBLE;
+        }
+        else
+        {
+            `$INSTANCE_NAME`_WrCntrlNib(`$INSTANCE_NAME`_flushByte);
+            `$INSTANCE_NAME`_waitTicks = `$INSTANCE_NAME`_initSequence[`$INSTANCE_NAME`_initStep].waitTicks;
+        }
+        `$INSTANCE_NAME`_initStep++;
+    }
+#if(`$INSTANCE_NAME`_CUSTOM_CHAR_SET != `$INSTANCE_NAME`_NONE)
+    else if(`$INSTANCE_NAME`_initStep < `$INSTANCE_NAME`_INIT_STEPS)
+    {
+        /* Custom fonts, CGRAM address was the last command */
+        `$INSTANCE_NAME`_flushByte = `$INSTANCE_NAME`_customFonts[`$INSTANCE_NAME`_initStep - `$INSTANCE_NAME`_INIT_SEQUENCE_LEN];
+        `$INSTANCE_NAME`_flushIsData = 1u;
+        `$INSTANCE_NAME`_flushWait = `$INSTANCE_NAME`_DATA_WAIT_TICKS;
+        `$INSTANCE_NAME`_WrDatNib(`$INSTANCE_NAME`_flushByte >> `$INSTANCE_NAME`_NIBBLE_SHIFT);
+        `$INSTANCE_NAME`_flushState = `$INSTANCE_NAME`_FLUSH_LOW_NIBBLE;
+        `$INSTANCE_NAME`_initStep++;
+    }
+#endif /* `$INSTANCE_NAME`_CUSTOM_CHAR_SET != `$INSTANCE_NAME`_NONE */
+    else
+    {
+    #if(`$INSTANCE_NAME`_CUSTOM_CHAR_SET != `$INSTANCE_NAME`_NONE)
+        /* Address counter is in CGRAM, the first flush must set it */
+        `$INSTANCE_NAME`_ddramAddr = 0u;
+    #endif /* `$INSTANCE_NAME`_CUSTOM_CHAR_SET != `$INSTANCE_NAME`_NONE */
+        `$INSTANCE_NAME`_initBusy = 0u;
+    }
 }
 
 
@@ -532,6 +1069,140 @@ static void `$INSTANCE_NAME`_WrCntrlNib(uint8 nibble) `=ReentrantKeil($INSTANCE_
         `$INSTANCE_NAME`_PrintString(&number[0u]);
     }
 
+
+    /*******************************************************************************
+    *  Function Name: `$INSTANCE_NAME`_FormatDecPadded
+    ********************************************************************************
+    *
+    * Summary:
+    *  Formats a signed value as a right-aligned, space-padded decimal field of
+    *  exactly width characters, like "%*ld" but without stdio. A value that
+    *  does not fit is shown as width `$INSTANCE_NAME`_DEC_OVERFLOW_CHAR
+    *  characters so a wrong reading is never displayed.
+    *
+    * Parameters:
+    *  string:  destination, at least width + 1 characters long
+    *  value:   the value to be formatted
+    *  width:   field width, 1 to `$INSTANCE_NAME`_DEC_MAX_WIDTH; 0 is taken
+    *           as 1 and larger values as `$INSTANCE_NAME`_DEC_MAX_WIDTH
+    *
+    * Return:
+    *  None.
+    *
+    *******************************************************************************/
+    void `$INSTANCE_NAME`_FormatDecPadded(char8 string[], int32 value, uint8 width) \
+                                                            `=ReentrantKeil($INSTANCE_NAME . "_FormatDecPadded")`
+    {
+        uint32 magnitude;
+        uint8 digIndex;
+
+        /* Keep the field inside string[], at least one digit */
+        if(width > `$INSTANCE_NAME`_DEC_MAX_WIDTH)
+        {
+            width = `$INSTANCE_NAME`_DEC_MAX_WIDTH;
+        }
+        else if(width == 0u)
+        {
+            width = 1u;
+        }
+        else
+        {
+            /* Width is in range */
+        }
+
+        magnitude = (value < 0) ? (0u - (uint32) value) : (uint32) value;
+
+        /* Fill digits from the right, least significant first */
+        digIndex = width;
+        do
+        {
+            digIndex--;
+            string[digIndex] = (char8)((magnitude % `$INSTANCE_NAME`_TEN) + '0');
+            magnitude /= `$INSTANCE_NAME`_TEN;
+        }
+        while((magnitude != 0u) && (digIndex != 0u));
+
+        if((value < 0) && (digIndex != 0u))
+        {
+            digIndex--;
+            string[digIndex] = (char8) '-';
+        }
+        else if((magnitude != 0u) || (value < 0))
+        {
+            /* Does not fit in the field */
+            digIndex = width;
+            while(digIndex != 0u)
+            {
+                digIndex--;
+                string[digIndex] = `$INSTANCE_NAME`_DEC_OVERFLOW_CHAR;
+            }
+        }
+        else
+        {
+            /* Value fits, nothing to add */
+        }
+
+        /* Pad the left of the field */
+        while(digIndex != 0u)
+        {
+            digIndex--;
+            string[digIndex] = (char8) ' ';
+        }
+
+        /* Null Termination */
+        string[width] = (char8) '\0';
+    }
+
+
+    /*******************************************************************************
+    *  Function Name: `$INSTANCE_NAME`_PrintDecPadded
+    ********************************************************************************
+    *
+    * Summary:
+    *  Prints a signed value as a right-aligned decimal field of exactly width
+    *  characters at the current cursor position.
+    *
+    * Parameters:
+    *  value:  the value to be printed
+    *  width:  field width, 1 to `$INSTANCE_NAME`_DEC_MAX_WIDTH
+    *
+    * Return:
+    *  None.
+    *
+    *******************************************************************************/
+    void `$INSTANCE_NAME`_PrintDecPadded(int32 value, uint8 width) `=ReentrantKeil($INSTANCE_NAME . "_PrintDecPadded")`
+    {
+        char8 number[`$INSTANCE_NAME`_DEC_MAX_WIDTH + 1u];
+
+        `$INSTANCE_NAME`_FormatDecPadded(number, value, width);
+        `$INSTANCE_NAME`_PrintString(number);
+    }
+
+
+    /*******************************************************************************
+    *  Function Name: `$INSTANCE_NAME`_BufPrintDecPadded
+    ********************************************************************************
+    *
+    * Summary:
+    *  Writes a signed value as a right-aligned decimal field of exactly width
+    *  characters at the frame buffer cursor.
+    *
+    * Parameters:
+    *  value:  the value to be written
+    *  width:  field width, 1 to `$INSTANCE_NAME`_DEC_MAX_WIDTH
+    *
+    * Return:
+    *  None.
+    *
+    *******************************************************************************/
+    void `$INSTANCE_NAME`_BufPrintDecPadded(int32 value, uint8 width) `=ReentrantKeil($INSTANCE_NAME . "_BufPrintDecPadded")`
+    {
+        char8 number[`$INSTANCE_NAME`_DEC_MAX_WIDTH + 1u];
+
+        `$INSTANCE_NAME`_FormatDecPadded(number, value, width);
+        `$INSTANCE_NAME`_BufPrintString(number);
+    }
+
 #endif /* `$INSTANCE_NAME`_CONVERSION_ROUTINES == 1u */
 
 
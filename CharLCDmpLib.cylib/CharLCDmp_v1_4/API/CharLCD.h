@@ -35,6 +35,17 @@
 #define `$INSTANCE_NAME`_VERTICAL_BG              (2u)    /* Vertical Bar Graph   */
 #define `$INSTANCE_NAME`_USER_DEFINED             (3u)    /* User Defined Fonts   */
 
+/* Shadow frame buffer geometry. May be overridden from the compiler command
+* line for larger glass; at most 32 columns are supported.
+*/
+#if !defined(`$INSTANCE_NAME`_BUF_ROWS)
+    #define `$INSTANCE_NAME`_BUF_ROWS             (2u)
+#endif /* !defined(`$INSTANCE_NAME`_BUF_ROWS) */
+
+#if !defined(`$INSTANCE_NAME`_BUF_COLUMNS)
+    #define `$INSTANCE_NAME`_BUF_COLUMNS          (16u)
+#endif /* !defined(`$INSTANCE_NAME`_BUF_COLUMNS) */
+
 
 /***************************************
 *     Data Struct Definitions
@@ -46,6 +57,15 @@ typedef struct
     uint8 enableState;
 } `$INSTANCE_NAME`_BACKUP_STRUCT;
 
+/* Bar graph drawn through the frame buffer, see InitHorizontalBG() */
+typedef struct
+{
+    uint8 row;              /* row of the first cell */
+    uint8 column;           /* column of the first cell */
+    uint8 maxCharacters;    /* length of the graph in cells */
+    uint8 value;            /* pixels currently drawn */
+} `$INSTANCE_NAME`_BAR_GRAPH_STRUCT;
+
 
 /***************************************
 *        Function Prototypes
@@ -54,6 +74,7 @@ typedef struct
 void `$INSTANCE_NAME`_Init(void) `=ReentrantKeil($INSTANCE_NAME . "_Init")`;
 void `$INSTANCE_NAME`_Enable(void) `=ReentrantKeil($INSTANCE_NAME . "_Enable")`;
 void `$INSTANCE_NAME`_Start(void) `=ReentrantKeil($INSTANCE_NAME . "_Start")`;
+void `$INSTANCE_NAME`_StartBackground(void) `=ReentrantKeil($INSTANCE_NAME . "_StartBackground")`;
 void `$INSTANCE_NAME`_Stop(void) `=ReentrantKeil($INSTANCE_NAME . "_Stop")`;
 void `$INSTANCE_NAME`_WriteControl(uint8 cByte) `=ReentrantKeil($INSTANCE_NAME . "_WriteControl")`;
 void `$INSTANCE_NAME`_WriteData(uint8 dByte) `=ReentrantKeil($INSTANCE_NAME . "_WriteData")`;
@@ -69,6 +90,18 @@ void `$INSTANCE_NAME`_Wakeup(void) `=ReentrantKeil($INSTANCE_NAME . "_Wakeup")`;
 #define `$INSTANCE_NAME`_PosPrintString(row, col, string) `$INSTANCE_NAME`_Position(row, col); `$INSTANCE_NAME`_PrintString(string); 
 #define `$INSTANCE_NAME`_PosPutChar(row, col, character) `$INSTANCE_NAME`_Position(row, col); `$INSTANCE_NAME`_PutChar(character); 
 
+/* Frame Buffer API */
+void `$INSTANCE_NAME`_BufClear(void) `=ReentrantKeil($INSTANCE_NAME . "_BufClear")`;
+void `$INSTANCE_NAME`_BufPosition(uint8 row, uint8 column) `=ReentrantKeil($INSTANCE_NAME . "_BufPosition")`;
+void `$INSTANCE_NAME`_BufPutChar(char8 character) `=ReentrantKeil($INSTANCE_NAME . "_BufPutChar")`;
+void `$INSTANCE_NAME`_BufPrintString(char8 const string[]) `=ReentrantKeil($INSTANCE_NAME . "_BufPrintString")`;
+void `$INSTANCE_NAME`_Flush(void) `=ReentrantKeil($INSTANCE_NAME . "_Flush")`;
+uint8 `$INSTANCE_NAME`_IsFlushing(void) `=ReentrantKeil($INSTANCE_NAME . "_IsFlushing")`;
+void `$INSTANCE_NAME`_FlushTick(void) `=ReentrantKeil($INSTANCE_NAME . "_FlushTick")`;
+
+#define `$INSTANCE_NAME`_BufPosPrintString(row, col, string) `$INSTANCE_NAME`_BufPosition(row, col); `$INSTANCE_NAME`_BufPrintString(string); 
+#define `$INSTANCE_NAME`_BufPosPutChar(row, col, character) `$INSTANCE_NAME`_BufPosition(row, col); `$INSTANCE_NAME`_BufPutChar(character); 
+
 #if((`$INSTANCE_NAME`_CUSTOM_CHAR_SET == `$INSTANCE_NAME`_VERTICAL_BG) || \
                 (`$INSTANCE_NAME`_CUSTOM_CHAR_SET == `$INSTANCE_NAME`_HORIZONTAL_BG))
 
@@ -81,6 +114,19 @@ void `$INSTANCE_NAME`_Wakeup(void) `=ReentrantKeil($INSTANCE_NAME . "_Wakeup")`;
     void `$INSTANCE_NAME`_DrawVerticalBG(uint8 row, uint8 column, uint8 maxCharacters, uint8 value)
                         `=ReentrantKeil($INSTANCE_NAME . "_DrawVerticalBG")`;
 
+    /* Incremental bar graphs in the frame buffer */
+    void `$INSTANCE_NAME`_InitHorizontalBG(`$INSTANCE_NAME`_BAR_GRAPH_STRUCT * barGraph, uint8 row, uint8 column,
+                        uint8 maxCharacters) `=ReentrantKeil($INSTANCE_NAME . "_InitHorizontalBG")`;
+
+    void `$INSTANCE_NAME`_UpdateHorizontalBG(`$INSTANCE_NAME`_BAR_GRAPH_STRUCT * barGraph, uint8 value)
+                        `=ReentrantKeil($INSTANCE_NAME . "_UpdateHorizontalBG")`;
+
+    void `$INSTANCE_NAME`_InitVerticalBG(`$INSTANCE_NAME`_BAR_GRAPH_STRUCT * barGraph, uint8 row, uint8 column,
+                        uint8 maxCharacters) `=ReentrantKeil($INSTANCE_NAME . "_InitVerticalBG")`;
+
+    void `$INSTANCE_NAME`_UpdateVerticalBG(`$INSTANCE_NAME`_BAR_GRAPH_STRUCT * barGraph, uint8 value)
+                        `=ReentrantKeil($INSTANCE_NAME . "_UpdateVerticalBG")`;
+
 #endif /* ((`$INSTANCE_NAME`_CUSTOM_CHAR_SET == `$INSTANCE_NAME`_VERTICAL_BG) */
 
 #if(`$INSTANCE_NAME`_CUSTOM_CHAR_SET == `$INSTANCE_NAME`_USER_DEFINED)
@@ -96,10 +142,16 @@ void `$INSTANCE_NAME`_Wakeup(void) `=ReentrantKeil($INSTANCE_NAME . "_Wakeup")`;
     void `$INSTANCE_NAME`_PrintInt8(uint8 value) `=ReentrantKeil($INSTANCE_NAME . "_PrintInt8")`;
     void `$INSTANCE_NAME`_PrintInt16(uint16 value) `=ReentrantKeil($INSTANCE_NAME . "_PrintInt16")`;
     void `$INSTANCE_NAME`_PrintNumber(uint16 value) `=ReentrantKeil($INSTANCE_NAME . "_PrintNumber")`; 
+    void `$INSTANCE_NAME`_FormatDecPadded(char8 string[], int32 value, uint8 width)
+                            `=ReentrantKeil($INSTANCE_NAME . "_FormatDecPadded")`;
+    void `$INSTANCE_NAME`_PrintDecPadded(int32 value, uint8 width) `=ReentrantKeil($INSTANCE_NAME . "_PrintDecPadded")`;
+    void `$INSTANCE_NAME`_BufPrintDecPadded(int32 value, uint8 width) `=ReentrantKeil($INSTANCE_NAME . "_BufPrintDecPadded")`;
 	
 	#define `$INSTANCE_NAME`_PosPrintInt8(row, col, value) `$INSTANCE_NAME`_Position(row, col); `$INSTANCE_NAME`_PrintInt8(value); 
 	#define `$INSTANCE_NAME`_PosPrintInt16(row, col, value) `$INSTANCE_NAME`_Position(row, col); `$INSTANCE_NAME`_PrintInt16(value);
 	#define `$INSTANCE_NAME`_PosPrintNumber(row, col, value) `$INSTANCE_NAME`_Position(row, col); `$INSTANCE_NAME`_PrintNumber(value);
+	#define `$INSTANCE_NAME`_PosPrintDecPadded(row, col, value, width) `$INSTANCE_NAME`_Position(row, col); `$INSTANCE_NAME`_PrintDecPadded(value, width);
+	#define `$INSTANCE_NAME`_BufPosPrintDecPadded(row, col, value, width) `$INSTANCE_NAME`_BufPosition(row, col); `$INSTANCE_NAME`_BufPrintDecPadded(value, width);
 
 #endif /* `$INSTANCE_NAME`_CONVERSION_ROUTINES == 1u */
 
@@ -158,6 +210,10 @@ extern uint8 const CYCODE `$INSTANCE_NAME`_customFonts[64u];
 #if(`$INSTANCE_NAME`_CONVERSION_ROUTINES == 1u)
     #define `$INSTANCE_NAME`_NUMBER_OF_REMAINDERS (0x05u)
     #define `$INSTANCE_NAME`_TEN                  (0x0Au)
+
+    /* Widest padded decimal field: sign and ten digits of an int32 */
+    #define `$INSTANCE_NAME`_DEC_MAX_WIDTH        (11u)
+    #define `$INSTANCE_NAME`_DEC_OVERFLOW_CHAR    ((char8) '*')
 #endif /* `$INSTANCE_NAME`_CONVERSION_ROUTINES == 1u */
 
 /* Nibble Offset and Mask */
@@ -192,6 +248,42 @@ extern uint8 const CYCODE `$INSTANCE_NAME`_customFonts[64u];
 #define `$INSTANCE_NAME`_NIB_DELAY_US               (100u)
 #define `$INSTANCE_NAME`_E_SETUP_US                   (2u)
 
+/* HD44780 write timing: address setup before E rises and E pulse width,
+* converted to cycles of the configured bus clock (rounded up). A control
+* register store takes at least STORE_CYCLES, shorter delays need no extra
+* wait.
+*/
+#define `$INSTANCE_NAME`_ADDRESS_SETUP_NS           (40u)
+#define `$INSTANCE_NAME`_E_PULSE_NS                 (230u)
+#define `$INSTANCE_NAME`_NS_TO_CYCLES(ns)           ((((BCLK__BUS_CLK__HZ / 1000u) * (ns)) + 999999u) / 1000000u)
+#define `$INSTANCE_NAME`_ADDRESS_SETUP_CYCLES       (`$INSTANCE_NAME`_NS_TO_CYCLES(`$INSTANCE_NAME`_ADDRESS_SETUP_NS))
+#define `$INSTANCE_NAME`_E_PULSE_CYCLES             (`$INSTANCE_NAME`_NS_TO_CYCLES(`$INSTANCE_NAME`_E_PULSE_NS))
+#define `$INSTANCE_NAME`_STORE_CYCLES               (2u)
+
+/* LCD_FlushTick() must be called every FLUSH_TICK_US; one nibble is
+* clocked out per tick and the byte delays above are counted in ticks.
+* Set DDRAM address executes as fast as a data write.
+*/
+#define `$INSTANCE_NAME`_FLUSH_TICK_US            (`$INSTANCE_NAME`_NIB_DELAY_US)
+#define `$INSTANCE_NAME`_DATA_WAIT_TICKS          (((`$INSTANCE_NAME`_DATA_DELAY_US + \
+                                                    `$INSTANCE_NAME`_FLUSH_TICK_US - 1u) / \
+                                                    `$INSTANCE_NAME`_FLUSH_TICK_US) - 1u)
+#define `$INSTANCE_NAME`_ADDR_WAIT_TICKS          (`$INSTANCE_NAME`_DATA_WAIT_TICKS)
+#define `$INSTANCE_NAME`_CMD_WAIT_TICKS           (((`$INSTANCE_NAME`_CMD_DELAY_US + \
+                                                    `$INSTANCE_NAME`_FLUSH_TICK_US - 1u) / \
+                                                    `$INSTANCE_NAME`_FLUSH_TICK_US) - 1u)
+
+/* Ticks for a delay of ms milliseconds, or us microseconds rounded up, as
+* counted by the flush state machine
+*/
+#define `$INSTANCE_NAME`_MS_TICKS(ms)               ((((ms) * 1000u) / `$INSTANCE_NAME`_FLUSH_TICK_US) - 1u)
+#define `$INSTANCE_NAME`_US_TICKS(us)               ((((us) + `$INSTANCE_NAME`_FLUSH_TICK_US - 1u) / \
+                                                    `$INSTANCE_NAME`_FLUSH_TICK_US) - 1u)
+
+/* Frame buffer flush state machine */
+#define `$INSTANCE_NAME`_FLUSH_IDLE               (0u)
+#define `$INSTANCE_NAME`_FLUSH_LOW_NIBBLE         (1u)
+
 
 
 /***************************************
@@ -210,7 +302,10 @@ extern uint8 const CYCODE `$INSTANCE_NAME`_customFonts[64u];
  *       Register Constants
  ***************************************/
                                                   
-/* Pin Masks */
+/* Pin Masks. The layout of Cntl_Port is fixed by the component schematic:
+* the data nibble on bits 0-3, E and RS above it. A nibble write is
+* therefore three whole-register stores, see WrBus().
+*/
 #define `$INSTANCE_NAME`_E                        ((uint8) 0x10u)
 #define `$INSTANCE_NAME`_RS                       ((uint8) 0x20u)
 //#define `$INSTANCE_NAME`_RW                       ((uint8) 0x40u)
@@ -0,0 +1,281 @@
+/******************************************************************************
+* File Name: buttons.c
+*
+* Version 1.0
+*
+* Description:
+* This file contains the front panel CapSense button task. The buttons are
+* scanned BUTTONS_SCAN_HZ times a second instead of on every main loop pass:
+* Buttons_Task() returns after a single tick compare until the next scan is
+* due, so baseline updates and widget checks no longer run within each pass
+* of the sample path. Each new press is latched as an event bit that the
+* main loop fetches with Buttons_GetEvents(). With PROFILE_ENABLE Misc also
+* has a long press, so its short press is only reported on release;
+* otherwise it is reported on the press like the other buttons.
+*
+*******************************************************************************/
+
+#include "buttons.h"
+#include "profile.h"
+
+/* In A and In B, the calibration mode combination */
+#define BUTTONS_IN_BOTH             (BUTTONS_EVENT_IN_A | BUTTONS_EVENT_IN_B)
+
+/* Buttons held at the last scan */
+static uint8 buttonsHeld = 0u;
+
+/* Press events not yet fetched by the main loop */
+static uint8 pendingEvents = 0u;
+
+#if(PROFILE_ENABLE == 1u)
+    /* Scans Misc has been held for, up to BUTTONS_LONG_PRESS_SCANS */
+    static uint16 miscScans = 0u;
+#endif /* PROFILE_ENABLE == 1u */
+
+/* Tick count of the last scan */
+static uint32 lastScan = 0u;
+
+
+/*******************************************************************************
+* Function Name: Buttons_Start
+********************************************************************************
+*
+* Summary:
+*  Starts CapSense, initializes the baselines and starts the first scan.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void Buttons_Start(void)
+{
+    /* Start capsense and initialize baselines and enable scan */
+    CapSense_Start();
+    CapSense_InitializeAllBaselines();
+    CapSense_ScanEnabledWidgets();
+
+    buttonsHeld = 0u;
+    pendingEvents = 0u;
+#if(PROFILE_ENABLE == 1u)
+    miscScans = 0u;
+#endif /* PROFILE_ENABLE == 1u */
+    lastScan = Tick_GetCount();
+}
+
+
+/*******************************************************************************
+* Function Name: Buttons_Sleep
+********************************************************************************
+*
+* Summary:
+*  Waits for the scan in progress and puts CapSense to sleep. Buttons_Task()
+*  must not be called until Buttons_Wakeup().
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void Buttons_Sleep(void)
+{
+    while(0u != CapSense_IsBusy())
+    {
+        /* a scan takes a few ms at most */
+    }
+
+    CapSense_Sleep();
+}
+
+
+/*******************************************************************************
+* Function Name: Buttons_Wakeup
+********************************************************************************
+*
+* Summary:
+*  Wakes CapSense after Buttons_Sleep() and starts a new scan. A button held
+*  across the sleep is reported as a new press.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void Buttons_Wakeup(void)
+{
+    CapSense_Wakeup();
+    CapSense_ScanEnabledWidgets();
+
+    buttonsHeld = 0u;
+#if(PROFILE_ENABLE == 1u)
+    miscScans = 0u;
+#endif /* PROFILE_ENABLE == 1u */
+    lastScan = Tick_GetCount();
+}
+
+
+/*******************************************************************************
+* Function Name: Buttons_Task
+********************************************************************************
+*
+* Summary:
+*  Once every BUTTONS_PERIOD_TICKS, evaluates the completed scan, latches
+*  the buttons that were pressed since the previous scan (with
+*  PROFILE_ENABLE, Misc: released, or held long enough) and starts the next
+*  scan. Returns immediately otherwise, or if the scan is still running.
+*  Run by the scheduler.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void Buttons_Task(void)
+{
+    uint32 now = Tick_GetCount();
+    uint8 held = 0u;
+
+    if(((now - lastScan) < BUTTONS_PERIOD_TICKS) || (0u != CapSense_IsBusy()))
+    {
+        return;
+    }
+    lastScan = now;
+
+    /* Update baseline for all the sensors */
+    CapSense_UpdateEnabledBaselines();
+
+    /* Test if button widgets are active */
+    if(0u != CapSense_CheckIsWidgetActive(CapSense_BUTTON0__BTN))
+    {
+        held |= BUTTONS_EVENT_IN_A;
+    }
+    if(0u != CapSense_CheckIsWidgetActive(CapSense_BUTTON1__BTN))
+    {
+        held |= BUTTONS_EVENT_IN_B;
+    }
+    if(0u != CapSense_CheckIsWidgetActive(CapSense_BUTTON2__BTN))
+    {
+        held |= BUTTONS_EVENT_MISC;
+    }
+
+    /* Only a new press is an event */
+#if(PROFILE_ENABLE == 1u)
+    pendingEvents |= held & (uint8) ~(buttonsHeld | BUTTONS_EVENT_MISC);
+#else
+    pendingEvents |= held & (uint8) ~buttonsHeld;
+#endif /* PROFILE_ENABLE == 1u */
+
+    /* In A and In B: once when both are down, in whatever order pressed */
+    if((BUTTONS_IN_BOTH == (held & BUTTONS_IN_BOTH)) &&
+       (BUTTONS_IN_BOTH != (buttonsHeld & BUTTONS_IN_BOTH)))
+    {
+        pendingEvents |= BUTTONS_EVENT_IN_AB;
+    }
+
+#if(PROFILE_ENABLE == 1u)
+    /* Misc: long press once while held, short press on release */
+    if(0u != (held & BUTTONS_EVENT_MISC))
+    {
+        if(miscScans < BUTTONS_LONG_PRESS_SCANS)
+        {
+            miscScans++;
+            if(BUTTONS_LONG_PRESS_SCANS == miscScans)
+            {
+                pendingEvents |= BUTTONS_EVENT_MISC_LONG;
+            }
+        }
+    }
+    else
+    {
+        if((0u != (buttonsHeld & BUTTONS_EVENT_MISC)) && (miscScans < BUTTONS_LONG_PRESS_SCANS))
+        {
+            pendingEvents |= BUTTONS_EVENT_MISC;
+        }
+        miscScans = 0u;
+    }
+#endif /* PROFILE_ENABLE == 1u */
+    buttonsHeld = held;
+
+    CapSense_ScanEnabledWidgets();
+}
+
+
+/*******************************************************************************
+* Function Name: Buttons_GetEvents
+********************************************************************************
+*
+* Summary:
+*  Returns the button presses since the previous call and clears them.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  BUTTONS_EVENT_* bit mask, 0 if no button was pressed.
+*
+*******************************************************************************/
+uint8 Buttons_GetEvents(void)
+{
+    uint8 events = pendingEvents;
+
+    pendingEvents = 0u;
+
+    return events;
+}
+
+
+/*******************************************************************************
+* Function Name: Buttons_GetHeld
+********************************************************************************
+*
+* Summary:
+*  Returns the buttons that were down at the last scan, for button
+*  combinations.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  BUTTONS_EVENT_* bit mask of the buttons held.
+*
+*******************************************************************************/
+uint8 Buttons_GetHeld(void)
+{
+    return buttonsHeld;
+}
+
+
+/*******************************************************************************
+* Function Name: Buttons_Clear
+********************************************************************************
+*
+* Summary:
+*  Drops the pending events and treats every button as held, so a button
+*  still down after a long operation (calibration mode) is not reported
+*  again; buttons are only reported once released and pressed anew.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void Buttons_Clear(void)
+{
+    pendingEvents = 0u;
+    buttonsHeld = BUTTONS_IN_BOTH | BUTTONS_EVENT_MISC;
+#if(PROFILE_ENABLE == 1u)
+    miscScans = BUTTONS_LONG_PRESS_SCANS; /* no short or long press on release */
+#endif /* PROFILE_ENABLE == 1u */
+}
+
+/* [] END OF FILE */
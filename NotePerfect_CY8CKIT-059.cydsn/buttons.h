@@ -0,0 +1,55 @@
+/******************************************************************************
+* File Name: buttons.h
+*
+* Version 1.0
+*
+* Description:
+* This file contains the constants and function prototypes for the
+* front panel CapSense button task.
+*
+*******************************************************************************/
+
+#if !defined(BUTTONS_H)
+#define BUTTONS_H
+
+#include <device.h>
+#include "tick.h"
+
+/* Button scan rate (in Hz) */
+#define BUTTONS_SCAN_HZ             (50u)
+
+/* Number of SysTick ticks between two scans */
+#define BUTTONS_PERIOD_TICKS        ((1000000u / TICK_PERIOD_US) / BUTTONS_SCAN_HZ)
+
+/* Misc held for this long is a long press */
+#define BUTTONS_LONG_PRESS_MS       (1000u)
+#define BUTTONS_LONG_PRESS_SCANS    ((BUTTONS_LONG_PRESS_MS * BUTTONS_SCAN_HZ) / 1000u)
+
+/* Button press events returned by Buttons_GetEvents(). In A and In B are
+* reported when pressed. Misc is reported when pressed too, or with
+* PROFILE_ENABLE (profile.h) when released after a short press and once on
+* a long press while still held. In A and In B together are also reported
+* once, at the scan that first finds both down.
+*/
+#define BUTTONS_EVENT_IN_A          (0x01u)     /* BUTTON0 */
+#define BUTTONS_EVENT_IN_B          (0x02u)     /* BUTTON1 */
+#define BUTTONS_EVENT_MISC          (0x04u)     /* BUTTON2 */
+#define BUTTONS_EVENT_MISC_LONG     (0x08u)     /* BUTTON2, held BUTTONS_LONG_PRESS_MS */
+#define BUTTONS_EVENT_IN_AB         (0x10u)     /* BUTTON0 and BUTTON1 down together */
+
+
+/***************************************
+*        Function Prototypes
+***************************************/
+
+void Buttons_Start(void);
+void Buttons_Task(void);
+void Buttons_Sleep(void);
+void Buttons_Wakeup(void);
+uint8 Buttons_GetEvents(void);
+uint8 Buttons_GetHeld(void);
+void Buttons_Clear(void);
+
+#endif /* BUTTONS_H */
+
+/* [] END OF FILE */
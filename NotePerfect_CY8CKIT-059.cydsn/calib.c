@@ -0,0 +1,383 @@
+/******************************************************************************
+* File Name: calib.c
+*
+* Version 1.0
+*
+* Description:
+* This file contains the output calibration. The gain and offset errors of
+* the RC-filtered PWM and its buffer vary from unit to unit; instead of
+* being folded into PWM_Lookup[] by hand they are measured and stored in a
+* per-unit record in EEPROM.
+*
+* Calibration mode (CALIB_ENABLE) is entered by pressing In A and In B
+* together. With the output jack patched to In_B (the potentiometer
+* header), every step is output through the table under test, measured with
+* the ADC after CALIB_SETTLE_MS and its table entry moved by the error, in
+* 1/2^NOTE_FINE_BITS counts. The ADC, with its internal reference, is the
+* measuring instrument: the loopback cannot tell an input error from an
+* output error, so the input side of the record is the ADC scaling the
+* output was measured with. Loading both together keeps quantizer and
+* output consistent even if the ADC trim is changed later.
+*
+* At boot Calib_Load() copies the record into RAM with one block read
+* from the memory-mapped EEPROM and checks it, which takes microseconds. A
+* blank or corrupt record falls back to PWM_FineLookup and the ADC
+* constants.
+*
+*******************************************************************************/
+
+#include "calib.h"
+#include "stddef.h"
+#include "string.h"
+
+/* Result of the last Calib_Load() */
+static uint8 recordValid = 0u;
+
+#if(CALIB_ENABLE == 1u)
+    #include "buttons.h"
+    #include "display.h"
+    #include "trigger.h"
+
+    /* Bytes covered by the checksum */
+    #define CALIB_CHECKSUM_BYTES    (offsetof(Calib_RECORD, checksum))
+
+    /* EEPROM rows taken by the record */
+    #define CALIB_ROWS              ((sizeof(Calib_RECORD) + CYDEV_EEPROM_ROW_SIZE - 1u) / \
+                                     CYDEV_EEPROM_ROW_SIZE)
+
+    /* Full-scale fine compare value */
+    #define CALIB_FINE_MAX          ((int32) NOTE_PWM_FINE(NUMBER_NOTE_PERFECT_STEPS))
+
+    /* RAM copy of the record, used by the output while valid */
+    static Calib_RECORD calib;
+
+    /* Record written by the calibration run */
+    static Calib_RECORD work;
+
+    static uint16 Calib_Checksum(Calib_RECORD const * record);
+    static int32 Calib_MeasureUv(void);
+    static cystatus Calib_Save(void);
+#endif /* CALIB_ENABLE == 1u */
+
+
+/*******************************************************************************
+* Function Name: Calib_Load
+********************************************************************************
+*
+* Summary:
+*  Copies the calibration record from EEPROM and installs it in the
+*  quantizer and the output, or installs the default scaling and table if
+*  there is no valid record. Must be called after ADC_Start() and before
+*  ADC_StartConvert().
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  Non-zero if the calibration record was valid.
+*
+*******************************************************************************/
+uint8 Calib_Load(void)
+{
+    uint8 valid = 0u;
+
+#if(CALIB_ENABLE == 1u)
+    EEPROM_Start();
+
+    /* One block read, EEPROM is mapped in the address space */
+    (void) memcpy(&calib, (void const *)(CYDEV_EE_BASE + (CALIB_EEPROM_FIRST_ROW * CYDEV_EEPROM_ROW_SIZE)),
+                  sizeof(calib));
+
+    valid = ((CALIB_MAGIC == calib.magic) && (CALIB_VERSION == calib.version) &&
+             (calib.countsPerVolt > 0) && (Calib_Checksum(&calib) == calib.checksum)) ? 1u : 0u;
+
+    if(0u != valid)
+    {
+        Quantizer_Init(calib.countsPerVolt, calib.offset);
+        Output_SetTable(calib.outputFine);
+    }
+    else
+#endif /* CALIB_ENABLE == 1u */
+    {
+        Quantizer_Init(ADC_CountsPerVolt, ADC_Offset);
+        Output_SetTable(NULL);
+    }
+
+    recordValid = valid;
+
+    return valid;
+}
+
+
+/*******************************************************************************
+* Function Name: Calib_IsValid
+********************************************************************************
+*
+* Summary:
+*  Reports whether the calibration record is in use or the built-in table.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  Non-zero if the last Calib_Load() found a valid record.
+*
+*******************************************************************************/
+uint8 Calib_IsValid(void)
+{
+    return recordValid;
+}
+
+
+#if(CALIB_ENABLE == 1u)
+
+    /*******************************************************************************
+    * Function Name: Calib_Run
+    ********************************************************************************
+    *
+    * Summary:
+    *  Calibration mode. Asks for the output to be patched to In_B, measures
+    *  and corrects every step CALIB_PASSES times and stores the new record.
+    *  Blocks the main loop for the whole run (about half a minute), so no
+    *  task runs: the outputs are parked at step 0 (0 V) on entry and,
+    *  with TRIGGER_ENABLE, the trigger interrupt is masked, so only the
+    *  output under test moves until the caller writes every note again.
+    *  The caller also redraws the display, reselects the input and clears
+    *  the buttons afterwards.
+    *
+    * Parameters:
+    *  None.
+    *
+    * Return:
+    *  Non-zero if a new record was stored; on cancel or failure the previous
+    *  calibration stays in use.
+    *
+    *******************************************************************************/
+    uint8 Calib_Run(void)
+    {
+        uint8 events;
+        uint8 pass;
+        uint32 step;
+        int32 targetUv;
+        int32 errorUv;
+        int32 fine;
+        uint8 stored = 0u;
+        uint8 channel;
+
+        /* Park the outputs, nothing updates them until the run is over */
+    #if(TRIGGER_ENABLE == 1u)
+        isr_Trigger_Disable();
+    #endif /* TRIGGER_ENABLE == 1u */
+        for(channel = 0u; channel < OUTPUT_CHANNELS; channel++)
+        {
+            Output_WriteStep(channel, 0u);
+        }
+
+        LCD_BufPosPrintString(0,0,"Cal: Out -> In B");
+        LCD_BufPosPrintString(1,0,"Misc=go In A=esc");
+        LCD_Flush();
+
+        /* Presses that entered calibration mode */
+        (void) Buttons_GetEvents();
+
+        do
+        {
+            Buttons_Task();
+            events = Buttons_GetEvents();
+        }
+        while(0u == (events & (BUTTONS_EVENT_MISC | BUTTONS_EVENT_IN_A)));
+
+        if(0u != (events & BUTTONS_EVENT_MISC))
+        {
+        #if(SAMPLER_ROUND_ROBIN == 0u)
+            myMux_FastSelect(IN_B);
+        #endif /* SAMPLER_ROUND_ROBIN == 0u */
+
+            /* Start from the nominal table and the current ADC scaling */
+            work.magic = CALIB_MAGIC;
+            work.version = CALIB_VERSION;
+            work.countsPerVolt = ADC_CountsPerVolt;
+            work.offset = ADC_Offset;
+            work.reserved = 0u;
+            for(step = 0u; step < NOTE_TABLE_SIZE; step++)
+            {
+                work.outputFine[step] = PWM_FineLookup[step];
+            }
+            Output_SetTable(work.outputFine);
+
+            LCD_BufPosPrintString(0,0,"Cal pass   step ");
+            LCD_BufPosPrintString(1,0,"err       uV    ");
+
+            stored = 1u;
+            for(pass = 0u; (pass < CALIB_PASSES) && (0u != stored); pass++)
+            {
+                for(step = 0u; (step <= NUMBER_NOTE_PERFECT_STEPS) && (0u != stored); step++)
+                {
+                    Output_WriteStep(CALIB_OUTPUT_CHANNEL, step); /* no transpose or glide */
+
+                    targetUv = (int32)((step * FULL_SCALE_MV * 1000u) / NUMBER_NOTE_PERFECT_STEPS);
+                    errorUv = targetUv - Calib_MeasureUv();
+
+                    LCD_BufPosPrintDecPadded(0,9,(int32) pass + 1,1u);
+                    LCD_BufPosPrintDecPadded(0,14,(int32) step,DISPLAY_STEP_WIDTH);
+                    LCD_BufPosPrintDecPadded(1,4,errorUv,6u);
+                    LCD_Flush();
+
+                    if((errorUv > CALIB_MAX_ERROR_UV) || (errorUv < -CALIB_MAX_ERROR_UV))
+                    {
+                        stored = 0u; /* not patched, or the output is broken */
+                    }
+                    else
+                    {
+                        /* Move the entry by the error, in fine PWM counts */
+                        fine = (int32) work.outputFine[step] +
+                               (int32)(((int64) errorUv * (int32) PWM_COUNTS_PER_VOLT * (1 << NOTE_FINE_BITS)) /
+                                       1000000);
+                        fine = (fine < 0) ? 0 : fine;
+                        fine = (fine > CALIB_FINE_MAX) ? CALIB_FINE_MAX : fine;
+                        work.outputFine[step] = (uint32) fine;
+                    }
+                }
+            }
+
+            if(0u != stored)
+            {
+                work.checksum = Calib_Checksum(&work);
+                stored = (CYRET_SUCCESS == Calib_Save()) ? 1u : 0u;
+            }
+        }
+
+        LCD_BufPosPrintString(0,0,(0u != stored) ? "Cal stored      " : "Cal not stored  ");
+        LCD_BufPosPrintString(1,0,"                ");
+        LCD_Flush();
+        CyDelay(1000u);
+        LCD_BufPosPrintString(0,0,"                ");
+        LCD_Flush();
+
+        /* Back to the record in EEPROM, new or previous */
+        (void) Calib_Load();
+
+    #if(TRIGGER_ENABLE == 1u)
+        isr_Trigger_Enable();
+    #endif /* TRIGGER_ENABLE == 1u */
+
+        return stored;
+    }
+
+
+    /*******************************************************************************
+    * Function Name: Calib_Checksum
+    ********************************************************************************
+    *
+    * Summary:
+    *  Fletcher-16 checksum of a record, without the checksum field.
+    *
+    * Parameters:
+    *  record:  record to check
+    *
+    * Return:
+    *  Checksum.
+    *
+    *******************************************************************************/
+    static uint16 Calib_Checksum(Calib_RECORD const * record)
+    {
+        uint8 const * bytes = (uint8 const *) record;
+        uint32 sum1 = 0u;
+        uint32 sum2 = 0u;
+        uint32 i;
+
+        for(i = 0u; i < CALIB_CHECKSUM_BYTES; i++)
+        {
+            sum1 = (sum1 + bytes[i]) % 255u;
+            sum2 = (sum2 + sum1) % 255u;
+        }
+
+        return (uint16)((sum2 << 8) | sum1);
+    }
+
+
+    /*******************************************************************************
+    * Function Name: Calib_MeasureUv
+    ********************************************************************************
+    *
+    * Summary:
+    *  Waits for the output to settle and returns the mean of
+    *  CALIB_AVERAGE_SAMPLES fresh conversions of In_B.
+    *
+    * Parameters:
+    *  None.
+    *
+    * Return:
+    *  In_B voltage in uV.
+    *
+    *******************************************************************************/
+    static int32 Calib_MeasureUv(void)
+    {
+    #if(SAMPLER_USE_DMA == 0u)
+        int32 samples[SAMPLER_BATCH_SIZE];
+    #endif /* SAMPLER_USE_DMA == 0u */
+        int64 sum = 0;
+        uint8 i;
+
+        CyDelay(CALIB_SETTLE_MS);
+
+        /* Drop the conversions taken while the output was settling */
+    #if(SAMPLER_USE_DMA == 1u)
+        (void) Sampler_WaitSample(CALIB_INPUT_CHANNEL);
+    #else
+        while(0u != Sampler_Read(CALIB_INPUT_CHANNEL, samples, SAMPLER_BATCH_SIZE))
+        {
+        }
+    #endif /* SAMPLER_USE_DMA == 1u */
+
+        for(i = 0u; i < CALIB_AVERAGE_SAMPLES; i++)
+        {
+            sum += Sampler_WaitSample(CALIB_INPUT_CHANNEL) - ADC_Offset;
+        }
+
+        return (int32)((sum * 1000000) / ((int64) ADC_CountsPerVolt * CALIB_AVERAGE_SAMPLES));
+    }
+
+
+    /*******************************************************************************
+    * Function Name: Calib_Save
+    ********************************************************************************
+    *
+    * Summary:
+    *  Writes the calibration record to EEPROM, one row at a time.
+    *
+    * Parameters:
+    *  None.
+    *
+    * Return:
+    *  CYRET_SUCCESS if every row was written.
+    *
+    *******************************************************************************/
+    static cystatus Calib_Save(void)
+    {
+        uint8 row[CYDEV_EEPROM_ROW_SIZE];
+        uint8 const * bytes = (uint8 const *) &work;
+        uint32 offset;
+        uint32 length;
+        uint8 i;
+        cystatus status = EEPROM_UpdateTemperature();
+
+        for(i = 0u; (i < CALIB_ROWS) && (CYRET_SUCCESS == status); i++)
+        {
+            /* The last row is padded with zeros */
+            offset = (uint32) i * CYDEV_EEPROM_ROW_SIZE;
+            length = sizeof(work) - offset;
+            length = (length > CYDEV_EEPROM_ROW_SIZE) ? CYDEV_EEPROM_ROW_SIZE : length;
+
+            (void) memset(row, 0, sizeof(row));
+            (void) memcpy(row, &bytes[offset], length);
+
+            status = EEPROM_Write(row, (uint8)(CALIB_EEPROM_FIRST_ROW + i));
+        }
+
+        return status;
+    }
+
+#endif /* CALIB_ENABLE == 1u */
+
+/* [] END OF FILE */
@@ -0,0 +1,83 @@
+/******************************************************************************
+* File Name: calib.h
+*
+* Version 1.0
+*
+* Description:
+* This file contains the constants, calibration record and function
+* prototypes of the output calibration stored in EEPROM.
+*
+*******************************************************************************/
+
+#if !defined(CALIB_H)
+#define CALIB_H
+
+#include <device.h>
+#include "notetable.h"
+#include "quantizer.h"
+#include "output.h"
+
+/* 1 = calibration mode and EEPROM record. Needs an EEPROM component named
+* EEPROM in TopDesign; with 0 the built-in tables are used as before.
+*/
+#define CALIB_ENABLE                (0u)
+
+/* Record identification, bump CALIB_VERSION when Calib_RECORD changes */
+#define CALIB_MAGIC                 (0x4E50u)   /* "NP" */
+#define CALIB_VERSION               (1u)
+
+/* First EEPROM row of the record */
+#define CALIB_EEPROM_FIRST_ROW      (0u)
+
+/* Output settling time after each step, at least 5 RC time constants */
+#define CALIB_SETTLE_MS             (50u)
+
+/* ADC conversions averaged per measurement */
+#define CALIB_AVERAGE_SAMPLES       (32u)
+
+/* Measure/correct passes over the steps; the second one removes what the
+* first left because of RC filter or opamp nonlinearity.
+*/
+#define CALIB_PASSES                (2u)
+
+/* A larger error means In_B is not patched to the output: abort */
+#define CALIB_MAX_ERROR_UV          (100000)
+
+/* Output looped back into In_B: the front panel PWM */
+#define CALIB_OUTPUT_CHANNEL        (SAMPLER_CHANNEL(IN_A))
+
+/* Sampler channel of In_B */
+#define CALIB_INPUT_CHANNEL         (SAMPLER_CHANNEL(IN_B))
+
+
+/***************************************
+*        Data Struct Definition
+***************************************/
+
+/* Calibration record, stored as is in EEPROM */
+typedef struct
+{
+    uint16 magic;                           /* CALIB_MAGIC */
+    uint16 version;                         /* CALIB_VERSION */
+    int32 countsPerVolt;                    /* ADC scaling the table was measured with */
+    int32 offset;
+    uint32 outputFine[NOTE_TABLE_SIZE];     /* corrected PWM_FineLookup */
+    uint16 checksum;                        /* Fletcher-16 of everything above */
+    uint16 reserved;
+} Calib_RECORD;
+
+
+/***************************************
+*        Function Prototypes
+***************************************/
+
+uint8 Calib_Load(void);
+uint8 Calib_IsValid(void);
+
+#if(CALIB_ENABLE == 1u)
+    uint8 Calib_Run(void);
+#endif /* CALIB_ENABLE == 1u */
+
+#endif /* CALIB_H */
+
+/* [] END OF FILE */
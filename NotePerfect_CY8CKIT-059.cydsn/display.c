@@ -0,0 +1,668 @@
+/******************************************************************************
+* File Name: display.c
+*
+* Version 1.0
+*
+* Description:
+* This file contains the LCD display task. The quantizer posts its latest
+* results with Display_Post() at full sample rate, which only stores them.
+* The conversion of the filtered counts to mV is done here, at display rate.
+* Display_Task() formats and flushes them DISPLAY_REFRESH_HZ times a second,
+* so string formatting and LCD traffic no longer scale with the ADC rate.
+* Fields are formatted with the LCD component's fixed-width decimal routines
+* instead of sprintf, so no stdio code is linked in.
+*
+* Display_NextPage() steps through the pages:
+*
+*  - readout: input, scale name, ADC profile tag and step on the top line,
+*    input in mV and the DAC value (or the level meter) on the bottom line.
+*  - scale: the notes of the selected scale.
+*  - calibration: calibration record in use and ADC resolution.
+*  - statistics (STATS_ENABLE): mean and largest correction in cents of the
+*    channel on the front panel and its correction histogram (stats.c), one
+*    digit per bin scaled to the fullest bin.
+*  - timing: sampler overruns and dropped telemetry/MIDI bytes or, with
+*    PERF_ENABLE, the mean, min and max cycle counts of one loop stage,
+*    stepping to the next stage every PERF_PAGE_SECONDS.
+*
+* Only the visible page is drawn. Each field keeps the value last shown and
+* is only formatted again when it changes; the labels are drawn once, when
+* the page is entered or one of them changes. The scale and calibration
+* pages only change through Display_Set*(), so they cost nothing between.
+*
+*******************************************************************************/
+
+#include "display.h"
+#include "notetable.h"
+#include "sampler.h"
+#include "scale.h"
+#include "calib.h"
+#include "profile.h"
+#include "telemetry.h"
+#include "midi.h"
+#include "stddef.h"
+
+/* Fields of each page, see Display_Changed() */
+#define DISPLAY_FIELD_MV            (0u)    /* readout */
+#define DISPLAY_FIELD_STEP          (1u)
+#define DISPLAY_FIELD_DAC           (2u)    /* or the meter level */
+#define DISPLAY_FIELD_MEAN          (0u)    /* statistics */
+#define DISPLAY_FIELD_MAX           (1u)
+#define DISPLAY_FIELD_BIN           (2u)    /* first of STATS_BINS */
+#define DISPLAY_FIELD_STAGE         (0u)    /* timing, PERF_ENABLE */
+#define DISPLAY_FIELD_CYCLES_MEAN   (1u)
+#define DISPLAY_FIELD_CYCLES_MIN    (2u)
+#define DISPLAY_FIELD_CYCLES_MAX    (3u)
+#define DISPLAY_FIELD_OVERRUNS      (0u)    /* timing */
+#define DISPLAY_FIELD_DROPS         (1u)
+#define DISPLAY_FIELDS              (DISPLAY_FIELD_BIN + STATS_BINS)
+
+/* Latest values posted by the quantizer */
+static volatile uint8 postedChannel = 0u;
+static volatile int32 postedCounts = 0;
+static volatile uint32 postedStep = 0u;
+static volatile uint16 postedDacValue = 0u;
+
+/* Tick count of the last refresh */
+static uint32 lastRefresh = 0u;
+
+/* Page shown, and the labels of the readout */
+static uint8 page = DISPLAY_PAGE_READOUT;
+static char8 const * inputLabel = "In A";
+static char8 const * scaleName = NULL;
+static char8 profileTag = ' ';
+
+/* Values shown on the page, and 1 = draw the whole page at the next
+* refresh */
+static int32 shown[DISPLAY_FIELDS];
+static uint8 redraw = 1u;
+
+/* 1 = turn the LCD back on before the next refresh, see Display_Wakeup() */
+static uint8 wakePending = 0u;
+
+static uint8 Display_Changed(uint8 field, int32 value);
+static void Display_DrawReadout(void);
+static void Display_DrawScale(void);
+static void Display_DrawCalib(void);
+static void Display_DrawTiming(void);
+
+#if(DISPLAY_METER == 1u)
+    /* Input level meter, redrawn incrementally */
+    static LCD_BAR_GRAPH_STRUCT meter;
+#endif /* DISPLAY_METER == 1u */
+
+#if((STATS_ENABLE == 1u) && (STATS_BINS > LCD_BUF_COLUMNS))
+    #error "The statistics page shows one bin per character, reduce STATS_BINS"
+#endif /* (STATS_ENABLE == 1u) && (STATS_BINS > LCD_BUF_COLUMNS) */
+
+#if(STATS_ENABLE == 1u)
+    static void Display_DrawStats(void);
+#endif /* STATS_ENABLE == 1u */
+
+#if(PERF_ENABLE == 1u)
+    /* Stage on the timing page and refreshes left before the next one */
+    static uint8 perfStage = PERF_STAGE_LOOP;
+    static uint8 perfRefreshes = DISPLAY_REFRESH_HZ * PERF_PAGE_SECONDS;
+#endif /* PERF_ENABLE == 1u */
+
+
+/*******************************************************************************
+* Function Name: Display_Start
+********************************************************************************
+*
+* Summary:
+*  Shows the readout page, drawn at the first call of Display_Task(). Must be
+*  called after LCD_StartBackground() (or LCD_Start()) and Tick_Start().
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void Display_Start(void)
+{
+    page = DISPLAY_PAGE_READOUT;
+    redraw = 1u;
+
+    lastRefresh = Tick_GetCount() - DISPLAY_PERIOD_TICKS;
+}
+
+
+/*******************************************************************************
+* Function Name: Display_SetInput
+********************************************************************************
+*
+* Summary:
+*  Shows the name of the active input channel.
+*
+* Parameters:
+*  label:  four character input name ("In A" or "In B")
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void Display_SetInput(char8 const label[])
+{
+    inputLabel = label;
+    redraw = 1u;
+}
+
+
+/*******************************************************************************
+* Function Name: Display_SetScale
+********************************************************************************
+*
+* Summary:
+*  Shows the name of the selected scale next to the input name, and its notes
+*  on the scale page.
+*
+* Parameters:
+*  name:  three character scale name, from Scale_GetName()
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void Display_SetScale(char8 const name[])
+{
+    scaleName = name;
+    redraw = 1u;
+}
+
+
+/*******************************************************************************
+* Function Name: Display_SetProfile
+********************************************************************************
+*
+* Summary:
+*  Shows the tag of the ADC profile between the scale name and the step, and
+*  its resolution on the calibration page.
+*
+* Parameters:
+*  tag:  one character, from Profile_GetTag()
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void Display_SetProfile(char8 tag)
+{
+    profileTag = tag;
+    redraw = 1u;
+}
+
+
+/*******************************************************************************
+* Function Name: Display_NextPage
+********************************************************************************
+*
+* Summary:
+*  Steps to the next page, drawn at the next refresh.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void Display_NextPage(void)
+{
+    page++;
+    if(DISPLAY_PAGE_COUNT == page)
+    {
+        page = DISPLAY_PAGE_READOUT;
+    }
+
+    redraw = 1u;
+}
+
+
+/*******************************************************************************
+* Function Name: Display_Wakeup
+********************************************************************************
+*
+* Summary:
+*  Turns the LCD back on after LCD_Sleep(), from the display task: the
+*  display on command uses the blocking LCD API, so it is sent at the next
+*  Display_Task() call that finds the background flush idle, and not from
+*  the caller (idle mode ends from within the sample task). The glass keeps
+*  its contents while off, so only the changed fields are drawn afterwards.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void Display_Wakeup(void)
+{
+    wakePending = 1u;
+}
+
+
+/*******************************************************************************
+* Function Name: Display_Post
+********************************************************************************
+*
+* Summary:
+*  Records the latest quantizer results for the next refresh. Cheap enough to
+*  be called for every sample.
+*
+* Parameters:
+*  channel:     input channel of the values
+*  counts:      filtered ADC counts
+*  step:        NotePerfect step number
+*  dacValue:    PWM compare value written to the output
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void Display_Post(uint8 channel, int32 counts, uint32 step, uint16 dacValue)
+{
+    postedChannel = channel;
+    postedCounts = counts;
+    postedStep = step;
+    postedDacValue = dacValue;
+}
+
+
+/*******************************************************************************
+* Function Name: Display_Task
+********************************************************************************
+*
+* Summary:
+*  Renders the visible page once every DISPLAY_PERIOD_TICKS and returns
+*  immediately otherwise. After Display_Wakeup() the LCD is turned on first,
+*  once the background flush is idle. Run by the scheduler.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void Display_Task(void)
+{
+    uint32 now = Tick_GetCount();
+
+    if(0u != wakePending)
+    {
+        if(0u != LCD_IsFlushing())
+        {
+            return; /* the blocking API must wait for the flush */
+        }
+        LCD_Wakeup();
+        wakePending = 0u;
+    }
+
+    if((now - lastRefresh) < DISPLAY_PERIOD_TICKS)
+    {
+        return;
+    }
+    lastRefresh = now;
+
+    if(DISPLAY_PAGE_READOUT == page)
+    {
+        Display_DrawReadout();
+    }
+    else if(DISPLAY_PAGE_SCALE == page)
+    {
+        Display_DrawScale();
+    }
+    else if(DISPLAY_PAGE_CALIB == page)
+    {
+        Display_DrawCalib();
+    }
+#if(STATS_ENABLE == 1u)
+    else if(DISPLAY_PAGE_STATS == page)
+    {
+        Display_DrawStats();
+    }
+#endif /* STATS_ENABLE == 1u */
+    else
+    {
+        Display_DrawTiming();
+    }
+    redraw = 0u;
+
+    /* hand the changed cells to the background flush */
+    LCD_Flush();
+}
+
+
+/*******************************************************************************
+* Function Name: Display_Changed
+********************************************************************************
+*
+* Summary:
+*  Records the value of a field of the visible page and tells whether it has
+*  to be formatted again.
+*
+* Parameters:
+*  field:  DISPLAY_FIELD_* of the visible page
+*  value:  value to show
+*
+* Return:
+*  Non-zero if the value differs from the one shown or the whole page is
+*  drawn.
+*
+*******************************************************************************/
+static uint8 Display_Changed(uint8 field, int32 value)
+{
+    uint8 changed = ((0u != redraw) || (shown[field] != value)) ? 1u : 0u;
+
+    shown[field] = value;
+
+    return changed;
+}
+
+
+/*******************************************************************************
+* Function Name: Display_DrawReadout
+********************************************************************************
+*
+* Summary:
+*  Draws the readout page.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+static void Display_DrawReadout(void)
+{
+    int32 mV = (int32) ADC_CountsTo_mVolts(postedCounts);
+#if(DISPLAY_METER == 1u)
+    int32 level;
+#endif /* DISPLAY_METER == 1u */
+
+    if(0u != redraw)
+    {
+        LCD_BufPosPrintString(0,0,"         Step=  ");
+        LCD_BufPosPrintString(0,0,inputLabel);
+        if(NULL != scaleName)
+        {
+            LCD_BufPosPrintString(0,DISPLAY_SCALE_COLUMN,scaleName);
+        }
+        LCD_BufPosPutChar(0,DISPLAY_PROFILE_COLUMN,profileTag);
+
+        /* Print mV unit on the LCD */
+        LCD_BufPosPrintString(1,0,"    mV          ");
+    #if(DISPLAY_METER == 1u)
+        LCD_InitHorizontalBG(&meter,DISPLAY_METER_ROW,DISPLAY_METER_COLUMN,DISPLAY_METER_CELLS);
+    #else
+        LCD_BufPosPrintString(1,8,"DAC=");
+    #endif /* DISPLAY_METER == 1u */
+    }
+
+#if(DISPLAY_METER == 1u)
+    /* Only the cells at the end of the bar that moved are rewritten */
+    level = (mV < 0) ? 0 : mV;
+    level = (level > (int32) FULL_SCALE_MV) ? (int32) FULL_SCALE_MV : level;
+    level = (int32)(((uint32) level * DISPLAY_METER_PIXELS) / FULL_SCALE_MV);
+    if(0u != Display_Changed(DISPLAY_FIELD_DAC, level))
+    {
+        LCD_UpdateHorizontalBG(&meter,(uint8) level);
+    }
+#else
+    if(0u != Display_Changed(DISPLAY_FIELD_DAC, (int32) postedDacValue))
+    {
+        LCD_BufPosPrintDecPadded(1,12,(int32) postedDacValue,DISPLAY_DAC_WIDTH);
+    }
+#endif /* DISPLAY_METER == 1u */
+
+    /* Convert notePerfectValue to string and display on the LCD */
+    if(0u != Display_Changed(DISPLAY_FIELD_STEP, (int32) postedStep))
+    {
+        LCD_BufPosPrintDecPadded(0,14,(int32) postedStep,DISPLAY_STEP_WIDTH);
+    }
+
+    /* Convert milli volts to string and display on the LCD */
+    if(0u != Display_Changed(DISPLAY_FIELD_MV, mV))
+    {
+        LCD_BufPosPrintDecPadded(1,0,mV,DISPLAY_MV_WIDTH);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: Display_DrawScale
+********************************************************************************
+*
+* Summary:
+*  Draws the scale page: the scale name, and one character per note of the
+*  octave, its name if the scale has it ("CcDdEFfGgAaB", lower case for the
+*  sharps; '*' unless 12 notes per volt) and '.' otherwise. Only drawn when
+*  the page is entered or the scale changes.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+static void Display_DrawScale(void)
+{
+#if(NUMBER_NOTES_PER_VOLT == 12u)
+    static char8 const CYCODE noteNames[] = "CcDdEFfGgAaB";
+#endif /* NUMBER_NOTES_PER_VOLT == 12u */
+    uint32 mask;
+    uint8 note;
+    char8 symbol;
+
+    if(0u == redraw)
+    {
+        return;
+    }
+
+    LCD_BufPosPrintString(0,0,"Scale           ");
+    if(NULL != scaleName)
+    {
+        LCD_BufPosPrintString(0,DISPLAY_SCALE_PAGE_COLUMN,scaleName);
+    }
+
+    LCD_BufPosPrintString(1,0,"                ");
+    mask = Scale_GetMask(Scale_GetSelected());
+    for(note = 0u; (note < NUMBER_NOTES_PER_VOLT) && (note < LCD_BUF_COLUMNS); note++)
+    {
+    #if(NUMBER_NOTES_PER_VOLT == 12u)
+        symbol = noteNames[note];
+    #else
+        symbol = '*';
+    #endif /* NUMBER_NOTES_PER_VOLT == 12u */
+        LCD_BufPosPutChar(1,note,(0u != (mask & (1uL << note))) ? symbol : '.');
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: Display_DrawCalib
+********************************************************************************
+*
+* Summary:
+*  Draws the calibration page: whether the stored calibration record or the
+*  nominal scaling is in use, and the resolution and tag of the ADC profile.
+*  Only drawn when the page is entered or the profile changes.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+static void Display_DrawCalib(void)
+{
+    if(0u == redraw)
+    {
+        return;
+    }
+
+    LCD_BufPosPrintString(0,0,(0u != Calib_IsValid()) ? "Cal stored      " : "Cal default     ");
+    LCD_BufPosPrintString(1,0,"ADC    bit      ");
+    LCD_BufPosPrintDecPadded(1,DISPLAY_CALIB_BITS_COLUMN,(int32) Profile_GetResolution(),DISPLAY_CALIB_BITS_WIDTH);
+    LCD_BufPosPutChar(1,DISPLAY_CALIB_TAG_COLUMN,profileTag);
+}
+
+
+#if(STATS_ENABLE == 1u)
+
+    /*******************************************************************************
+    * Function Name: Display_DrawStats
+    ********************************************************************************
+    *
+    * Summary:
+    *  Draws the statistics page: mean and largest correction of the posted
+    *  channel, and one digit per histogram bin, from '1' for a few samples
+    *  to '9' for the fullest bin, blank for an empty bin.
+    *
+    * Parameters:
+    *  None.
+    *
+    * Return:
+    *  None.
+    *
+    *******************************************************************************/
+    static void Display_DrawStats(void)
+    {
+        Stats_HISTOGRAM histogram;
+        uint16 peak = 0u;
+        uint8 bin;
+        int32 mean;
+        char8 digit;
+        uint8 channel = postedChannel;
+
+        if(0u != redraw)
+        {
+            LCD_BufPosPrintString(0,0,"avg    c max   c");
+            LCD_BufPosPrintString(1,0,"                ");
+        }
+
+        Stats_GetHistogram(channel, &histogram);
+
+        mean = Stats_GetMean(channel);
+        if(0u != Display_Changed(DISPLAY_FIELD_MEAN, mean))
+        {
+            LCD_BufPosPrintDecPadded(0,3,mean,DISPLAY_STATS_MEAN_WIDTH);
+        }
+        if(0u != Display_Changed(DISPLAY_FIELD_MAX, (int32) histogram.maxCents))
+        {
+            LCD_BufPosPrintDecPadded(0,DISPLAY_STATS_MAX_COLUMN,(int32) histogram.maxCents,DISPLAY_STATS_MAX_WIDTH);
+        }
+
+        for(bin = 0u; bin < STATS_BINS; bin++)
+        {
+            peak = (histogram.bins[bin] > peak) ? histogram.bins[bin] : peak;
+        }
+
+        for(bin = 0u; bin < STATS_BINS; bin++)
+        {
+            digit = (0u == histogram.bins[bin]) ? ' ' :
+                    (char8)('1' + (((uint32) histogram.bins[bin] * 8u) / peak));
+            if(0u != Display_Changed(DISPLAY_FIELD_BIN + bin, (int32) digit))
+            {
+                LCD_BufPosPutChar(1,bin,digit);
+            }
+        }
+    }
+
+#endif /* STATS_ENABLE == 1u */
+
+
+/*******************************************************************************
+* Function Name: Display_DrawTiming
+********************************************************************************
+*
+* Summary:
+*  Draws the timing page. With PERF_ENABLE: "<stage> avg <mean>" on the top
+*  line and "<min>-<max>" on the bottom line, all in CPU cycles. Otherwise
+*  the sampler overruns and the telemetry and MIDI bytes dropped.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+static void Display_DrawTiming(void)
+{
+#if(PERF_ENABLE == 1u)
+    Perf_STATS stats;
+    int32 mean;
+
+    if(0u == perfRefreshes)
+    {
+        perfStage++;
+        if(PERF_STAGE_COUNT == perfStage)
+        {
+            perfStage = PERF_STAGE_LOOP;
+        }
+        perfRefreshes = DISPLAY_REFRESH_HZ * PERF_PAGE_SECONDS;
+    }
+    perfRefreshes--;
+
+    if(0u != redraw)
+    {
+        LCD_BufPosPrintString(0,0,"                ");
+        LCD_BufPosPrintString(0,PERF_NAME_LENGTH," avg");
+        LCD_BufPosPrintString(1,0,"                ");
+        LCD_BufPosPutChar(1,DISPLAY_PERF_MIN_WIDTH,'-');
+    }
+
+    Perf_GetStats(perfStage, &stats);
+    if(0u == stats.count)
+    {
+        stats.min = 0u;
+        stats.total = 0u;
+        stats.count = 1u;
+    }
+    mean = (int32)(stats.total / stats.count);
+
+    if(0u != Display_Changed(DISPLAY_FIELD_STAGE, (int32) perfStage))
+    {
+        LCD_BufPosPrintString(0,0,Perf_GetName(perfStage));
+    }
+    if(0u != Display_Changed(DISPLAY_FIELD_CYCLES_MEAN, mean))
+    {
+        LCD_BufPosPrintDecPadded(0,DISPLAY_PERF_MEAN_COLUMN,mean,DISPLAY_PERF_MEAN_WIDTH);
+    }
+    if(0u != Display_Changed(DISPLAY_FIELD_CYCLES_MIN, (int32) stats.min))
+    {
+        LCD_BufPosPrintDecPadded(1,0,(int32) stats.min,DISPLAY_PERF_MIN_WIDTH);
+    }
+    if(0u != Display_Changed(DISPLAY_FIELD_CYCLES_MAX, (int32) stats.max))
+    {
+        LCD_BufPosPrintDecPadded(1,DISPLAY_PERF_MIN_WIDTH + 1u,(int32) stats.max,DISPLAY_PERF_MAX_WIDTH);
+    }
+#else
+    int32 drops = (int32)(Telemetry_GetDrops() + Midi_GetDrops());
+
+    if(0u != redraw)
+    {
+        LCD_BufPosPrintString(0,0,"Overruns        ");
+        LCD_BufPosPrintString(1,0,"Drops           ");
+    }
+
+    if(0u != Display_Changed(DISPLAY_FIELD_OVERRUNS, (int32) Sampler_GetOverruns()))
+    {
+        LCD_BufPosPrintDecPadded(0,DISPLAY_TIMING_COLUMN,(int32) Sampler_GetOverruns(),DISPLAY_TIMING_WIDTH);
+    }
+    if(0u != Display_Changed(DISPLAY_FIELD_DROPS, drops))
+    {
+        LCD_BufPosPrintDecPadded(1,DISPLAY_TIMING_COLUMN,drops,DISPLAY_TIMING_WIDTH);
+    }
+#endif /* PERF_ENABLE == 1u */
+}
+
+/* [] END OF FILE */
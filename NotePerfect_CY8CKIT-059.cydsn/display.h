@@ -0,0 +1,104 @@
+/******************************************************************************
+* File Name: display.h
+*
+* Version 1.0
+*
+* Description:
+* This file contains the constants and function prototypes for the
+* fixed-rate, paged LCD display task.
+*
+*******************************************************************************/
+
+#if !defined(DISPLAY_H)
+#define DISPLAY_H
+
+#include <device.h>
+#include "tick.h"
+#include "perf.h"
+#include "stats.h"
+
+/* LCD refresh rate (in Hz), independent of the ADC sample rate */
+#define DISPLAY_REFRESH_HZ          (15u)
+
+/* Number of SysTick ticks between two refreshes */
+#define DISPLAY_PERIOD_TICKS        ((1000000u / TICK_PERIOD_US) / DISPLAY_REFRESH_HZ)
+
+/* Width of the numeric fields (in characters) */
+#define DISPLAY_MV_WIDTH            (4u)
+#define DISPLAY_STEP_WIDTH          (2u)
+#define DISPLAY_DAC_WIDTH           (4u)
+
+/* First column of the scale name on the top line */
+#define DISPLAY_SCALE_COLUMN        (5u)
+
+/* Column of the ADC profile tag (profile.h), between scale and step */
+#define DISPLAY_PROFILE_COLUMN      (8u)
+
+/* 1 = level meter of the input CV in place of the DAC readout. Needs the
+* LCD custom character set to be "Horizontal Bargraph" in the customizer.
+*/
+#define DISPLAY_METER               (0u)
+
+/* Meter position and length (in characters) */
+#define DISPLAY_METER_ROW           (1u)
+#define DISPLAY_METER_COLUMN        (8u)
+#define DISPLAY_METER_CELLS         (8u)
+#define DISPLAY_METER_PIXELS        (DISPLAY_METER_CELLS * LCD_CHARACTER_WIDTH)
+
+#if((DISPLAY_METER == 1u) && (LCD_CUSTOM_CHAR_SET != LCD_HORIZONTAL_BG))
+    #error "DISPLAY_METER needs the LCD Horizontal Bargraph character set"
+#endif /* (DISPLAY_METER == 1u) && (LCD_CUSTOM_CHAR_SET != LCD_HORIZONTAL_BG) */
+
+/* Pages stepped through with Display_NextPage() */
+#define DISPLAY_PAGE_READOUT        (0u)
+#define DISPLAY_PAGE_SCALE          (1u)
+#define DISPLAY_PAGE_CALIB          (2u)
+#if(STATS_ENABLE == 1u)
+    #define DISPLAY_PAGE_STATS      (3u)
+    #define DISPLAY_PAGE_TIMING     (4u)
+    #define DISPLAY_PAGE_COUNT      (5u)
+#else
+    #define DISPLAY_PAGE_TIMING     (3u)
+    #define DISPLAY_PAGE_COUNT      (4u)
+#endif /* STATS_ENABLE == 1u */
+
+/* Scale page layout */
+#define DISPLAY_SCALE_PAGE_COLUMN   (6u)
+
+/* Calibration page layout */
+#define DISPLAY_CALIB_BITS_COLUMN   (4u)
+#define DISPLAY_CALIB_BITS_WIDTH    (2u)
+#define DISPLAY_CALIB_TAG_COLUMN    (15u)
+
+/* Statistics page layout (STATS_ENABLE) */
+#define DISPLAY_STATS_MEAN_WIDTH    (4u)
+#define DISPLAY_STATS_MAX_COLUMN    (12u)
+#define DISPLAY_STATS_MAX_WIDTH     (3u)
+
+/* Timing page layout */
+#define DISPLAY_TIMING_COLUMN       (9u)
+#define DISPLAY_TIMING_WIDTH        (7u)
+
+/* Timing page layout with PERF_ENABLE */
+#define DISPLAY_PERF_MEAN_COLUMN    (8u)
+#define DISPLAY_PERF_MEAN_WIDTH     (8u)
+#define DISPLAY_PERF_MIN_WIDTH      (7u)
+#define DISPLAY_PERF_MAX_WIDTH      (8u)
+
+
+/***************************************
+*        Function Prototypes
+***************************************/
+
+void Display_Start(void);
+void Display_SetInput(char8 const label[]);
+void Display_SetScale(char8 const name[]);
+void Display_SetProfile(char8 tag);
+void Display_NextPage(void);
+void Display_Wakeup(void);
+void Display_Post(uint8 channel, int32 counts, uint32 step, uint16 dacValue);
+void Display_Task(void);
+
+#endif /* DISPLAY_H */
+
+/* [] END OF FILE */
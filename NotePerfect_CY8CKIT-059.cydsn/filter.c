@@ -0,0 +1,381 @@
+/******************************************************************************
+* File Name: filter.c
+*
+* Version 1.0
+*
+* Description:
+* This file contains the filter applied to the ADC conversions before they
+* are used in NotePerfect calculations. One of four filters is compiled in,
+* selected by FILTER_TYPE in filter.h:
+*
+* 1. Boxcar: the original MAX_SAMPLE moving average (512 bytes of RAM).
+*
+* 2. IIR: a single-pole low pass, avg += (sample - avg) / 2^k,
+*    kept as a scaled accumulator so no resolution is lost. One word of
+*    state, two adds and two shifts per sample.
+*
+* 3. CIC: an N-stage cascaded integrator-comb decimator followed by a
+*    {1, 3, 3, 1} FIR on the decimated output. The integrators run on every
+*    sample and the combs and FIR once every FILTER_CIC_DECIMATION samples.
+*    The integrators and combs rely on wrap-around arithmetic, which is
+*    fine as long as the true output fits in 32 bits. To make a reset O(1)
+*    the stages filter the difference from a base value instead of the raw
+*    counts: with a zero state and an input equal to the base the filter is
+*    already settled.
+*
+* 4. Adaptive (default): the IIR with a time constant that follows the signal. A
+*    jump shortens it to a couple of samples so a new note is picked up
+*    almost at once, and every 2^shift quiet samples it is doubled again
+*    until the full 2^FILTER_IIR_SHIFT noise rejection is back. The
+*    accumulator is always scaled by 2^FILTER_IIR_SHIFT, so changing the
+*    time constant needs no rescaling and the cost per sample is constant.
+*
+* For the first three types a sharp change in the signal (more than
+* SIGNAL_SLOPE counts away from the average) resets the filter to the new
+* value so the quantizer follows steps immediately. Only the boxcar needs a
+* loop to do so. The adaptive filter does not reset, it speeds up instead.
+*
+* Each input channel (one, or two in SAMPLER_ROUND_ROBIN mode) has its own
+* filter state.
+*
+* The jump threshold and the IIR time constant are shared by all channels
+* and can be changed at run time with Filter_SetProfile(), to follow the ADC
+* resolution (profile.c). The boxcar length and the CIC ratio are fixed.
+*
+*******************************************************************************/
+
+#include "filter.h"
+#include "stdlib.h"
+
+/* Every state variable has one entry per input channel */
+
+/* Variable to hold the filtered value */
+static int32 averageCounts[FILTER_CHANNELS];
+
+/* Jump threshold in use, set by Filter_SetProfile() */
+static int32 signalSlope = SIGNAL_SLOPE;
+
+#if(FILTER_TYPE == FILTER_TYPE_BOXCAR)
+
+    /* Array to store ADC count for moving average filter */
+    static int32 adcCounts[FILTER_CHANNELS][MAX_SAMPLE];
+
+    /* Variable to store accumulated sample for filter array */
+    static int32 sum[FILTER_CHANNELS];
+
+    /* Index variable to work on the filter array */
+    static uint8 index[FILTER_CHANNELS];
+
+#elif((FILTER_TYPE == FILTER_TYPE_IIR) || (FILTER_TYPE == FILTER_TYPE_ADAPTIVE))
+
+    /* Average scaled by 2^FILTER_IIR_SHIFT */
+    static int32 accumulator[FILTER_CHANNELS];
+
+    /* 2^iirShift samples time constant, the longest one if adaptive */
+    static uint8 iirShift = FILTER_IIR_SHIFT;
+
+    #if(FILTER_TYPE == FILTER_TYPE_ADAPTIVE)
+        /* Current time constant is 2^shift samples */
+        static uint8 shift[FILTER_CHANNELS];
+
+        /* Quiet samples at the current time constant */
+        static uint8 settleCount[FILTER_CHANNELS];
+    #endif /* FILTER_TYPE == FILTER_TYPE_ADAPTIVE */
+
+#elif(FILTER_TYPE == FILTER_TYPE_CIC)
+
+    /* Counts the filter stages are relative to */
+    static int32 base[FILTER_CHANNELS];
+
+    static uint32 integrator[FILTER_CHANNELS][FILTER_CIC_ORDER];
+    static uint32 combDelay[FILTER_CHANNELS][FILTER_CIC_ORDER];
+    static int32 firDelay[FILTER_CHANNELS][FILTER_FIR_TAPS];
+
+    /* Input samples until the next decimated output */
+    static uint8 phase[FILTER_CHANNELS];
+
+#else
+    #error "Unknown FILTER_TYPE"
+#endif /* FILTER_TYPE */
+
+
+/*******************************************************************************
+* Function Name: Filter_Init
+********************************************************************************
+*
+* Summary:
+*  Sets the filter state so the average equals one sample.
+*
+* Parameters:
+*  channel:  input channel, 0 .. FILTER_CHANNELS - 1
+*  sample:   ADC counts used to seed the filter
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void Filter_Init(uint8 channel, int32 sample)
+{
+#if(FILTER_TYPE == FILTER_TYPE_BOXCAR)
+
+    uint8 i;
+
+    for(i = 0u; i < MAX_SAMPLE; i++)
+    {
+        adcCounts[channel][i] = sample;
+    }
+
+    /* Store sum of 128 samples*/
+    sum[channel] = sample << DIV;
+    index[channel] = 0u;
+
+#elif((FILTER_TYPE == FILTER_TYPE_IIR) || (FILTER_TYPE == FILTER_TYPE_ADAPTIVE))
+
+    accumulator[channel] = sample << FILTER_IIR_SHIFT;
+
+    #if(FILTER_TYPE == FILTER_TYPE_ADAPTIVE)
+        shift[channel] = iirShift;
+        settleCount[channel] = 0u;
+    #endif /* FILTER_TYPE == FILTER_TYPE_ADAPTIVE */
+
+#else
+
+    uint8 i;
+
+    /* A zero state is settled for an input equal to the base */
+    base[channel] = sample;
+
+    for(i = 0u; i < FILTER_CIC_ORDER; i++)
+    {
+        integrator[channel][i] = 0u;
+        combDelay[channel][i] = 0u;
+    }
+
+    for(i = 0u; i < FILTER_FIR_TAPS; i++)
+    {
+        firDelay[channel][i] = 0;
+    }
+
+    phase[channel] = 0u;
+
+#endif /* FILTER_TYPE */
+
+    /* Average count is equal to new sample */
+    averageCounts[channel] = sample;
+}
+
+
+/*******************************************************************************
+* Function Name: Filter_Process
+********************************************************************************
+*
+* Summary:
+*  Adds one ADC conversion to the filter.
+*
+* Parameters:
+*  channel:  input channel, 0 .. FILTER_CHANNELS - 1
+*  sample:   ADC counts
+*
+* Return:
+*  Filtered ADC counts.
+*
+*******************************************************************************/
+int32 Filter_Process(uint8 channel, int32 sample)
+{
+    /* calculate instantaneous difference to determine if abrupt change has happened */
+    int32 diff = abs(averageCounts[channel] - sample);
+
+#if(FILTER_TYPE == FILTER_TYPE_CIC)
+    uint32 value;
+    int32 decimated;
+    int32 * fir;
+    uint8 i;
+#endif /* FILTER_TYPE == FILTER_TYPE_CIC */
+
+#if(FILTER_TYPE == FILTER_TYPE_ADAPTIVE)
+
+    /* Jumps shorten the time constant, quiet samples widen it again */
+    if(diff > signalSlope)
+    {
+        shift[channel] = FILTER_ADAPTIVE_MIN_SHIFT;
+        settleCount[channel] = 0u;
+    }
+    else if((diff > FILTER_ADAPTIVE_THRESHOLD(signalSlope)) && (shift[channel] > FILTER_ADAPTIVE_MIN_SHIFT))
+    {
+        shift[channel]--;
+        settleCount[channel] = 0u;
+    }
+    else if(shift[channel] < iirShift)
+    {
+        settleCount[channel]++;
+        if(settleCount[channel] >= (1u << shift[channel]))
+        {
+            shift[channel]++;
+            settleCount[channel] = 0u;
+        }
+    }
+    else
+    {
+        /* full noise rejection */
+    }
+
+    accumulator[channel] += ((sample << FILTER_IIR_SHIFT) - accumulator[channel]) >> shift[channel];
+    averageCounts[channel] = accumulator[channel] >> FILTER_IIR_SHIFT;
+
+#else
+
+    /* If sharp change in the signal then reset the filter with the new signal value */
+    if(diff > signalSlope)
+    {
+        Filter_Init(channel, sample);
+    }
+
+    /* Get filtered value */
+    else
+    {
+#if(FILTER_TYPE == FILTER_TYPE_BOXCAR)
+
+        /* Remove the oldest element and add new sample to sum and get the average */
+        sum[channel] = sum[channel] - adcCounts[channel][index[channel]];
+        sum[channel] = sum[channel] + sample;
+        averageCounts[channel] = sum[channel] >> DIV;
+
+        /* Remove the oldest sample and store new sample */
+        adcCounts[channel][index[channel]] = sample;
+        index[channel]++;
+        if(index[channel] == MAX_SAMPLE)
+        {
+            index[channel] = 0u;
+        }
+
+#elif(FILTER_TYPE == FILTER_TYPE_IIR)
+
+        accumulator[channel] += ((sample << FILTER_IIR_SHIFT) - accumulator[channel]) >> iirShift;
+        averageCounts[channel] = accumulator[channel] >> FILTER_IIR_SHIFT;
+
+#else
+
+        /* Integrators at the input rate */
+        value = (uint32)(sample - base[channel]);
+        for(i = 0u; i < FILTER_CIC_ORDER; i++)
+        {
+            integrator[channel][i] += value;
+            value = integrator[channel][i];
+        }
+
+        phase[channel]++;
+        if(FILTER_CIC_DECIMATION == phase[channel])
+        {
+            phase[channel] = 0u;
+
+            /* Combs at the decimated rate */
+            for(i = 0u; i < FILTER_CIC_ORDER; i++)
+            {
+                uint32 comb = value - combDelay[channel][i];
+                combDelay[channel][i] = value;
+                value = comb;
+            }
+
+            decimated = (int32) value >> FILTER_CIC_GAIN_SHIFT;
+
+            /* FIR {1, 3, 3, 1} on the decimated samples */
+            fir = firDelay[channel];
+            fir[3u] = fir[2u];
+            fir[2u] = fir[1u];
+            fir[1u] = fir[0u];
+            fir[0u] = decimated;
+
+            averageCounts[channel] = base[channel] + ((fir[0u] + (3 * (fir[1u] + fir[2u])) + fir[3u])
+                                                      >> FILTER_FIR_GAIN_SHIFT);
+        }
+
+#endif /* FILTER_TYPE */
+    }
+
+#endif /* FILTER_TYPE == FILTER_TYPE_ADAPTIVE */
+
+    return averageCounts[channel];
+}
+
+
+/*******************************************************************************
+* Function Name: Filter_ProcessBlock
+********************************************************************************
+*
+* Summary:
+*  Runs a whole block of ADC conversions through the filter.
+*
+* Parameters:
+*  channel:  input channel, 0 .. FILTER_CHANNELS - 1
+*  samples:  ADC counts, oldest first
+*  count:    number of samples in the block
+*
+* Return:
+*  Filtered ADC counts after the last sample of the block.
+*
+*******************************************************************************/
+int32 Filter_ProcessBlock(uint8 channel, int32 const samples[], uint8 count)
+{
+    uint8 i;
+
+    for(i = 0u; i < count; i++)
+    {
+        (void) Filter_Process(channel, samples[i]);
+    }
+
+    return averageCounts[channel];
+}
+
+
+/*******************************************************************************
+* Function Name: Filter_GetAverage
+********************************************************************************
+*
+* Summary:
+*  Returns the current filter output without adding a sample.
+*
+* Parameters:
+*  channel:  input channel, 0 .. FILTER_CHANNELS - 1
+*
+* Return:
+*  Filtered ADC counts.
+*
+*******************************************************************************/
+int32 Filter_GetAverage(uint8 channel)
+{
+    return averageCounts[channel];
+}
+
+
+
+/*******************************************************************************
+* Function Name: Filter_SetProfile
+********************************************************************************
+*
+* Summary:
+*  Sets the jump threshold and the IIR time constant of every channel, e.g.
+*  for a new ADC resolution. Filter_Init() must be called for every channel
+*  afterwards. The time constant is ignored by the boxcar and CIC filters.
+*
+* Parameters:
+*  slope:     jump threshold in ADC counts, replaces SIGNAL_SLOPE
+*  tauShift:  time constant of 2^tauShift samples, limited to
+*             FILTER_ADAPTIVE_MIN_SHIFT .. FILTER_IIR_SHIFT
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void Filter_SetProfile(int32 slope, uint8 tauShift)
+{
+    signalSlope = (slope < 1) ? 1 : slope;
+
+#if((FILTER_TYPE == FILTER_TYPE_IIR) || (FILTER_TYPE == FILTER_TYPE_ADAPTIVE))
+    tauShift = (tauShift < FILTER_ADAPTIVE_MIN_SHIFT) ? FILTER_ADAPTIVE_MIN_SHIFT : tauShift;
+    iirShift = (tauShift > FILTER_IIR_SHIFT) ? FILTER_IIR_SHIFT : tauShift;
+#else
+    (void) tauShift;
+#endif /* (FILTER_TYPE == FILTER_TYPE_IIR) || (FILTER_TYPE == FILTER_TYPE_ADAPTIVE) */
+}
+
+/* [] END OF FILE */
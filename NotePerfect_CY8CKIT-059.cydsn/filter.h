@@ -0,0 +1,101 @@
+/******************************************************************************
+* File Name: filter.h
+*
+* Version 1.0
+*
+* Description:
+* This file contains the constants and function prototypes for the ADC
+* filter stage. The filter type and its time constants are selected with
+* the #defines below.
+*
+*******************************************************************************/
+
+#if !defined(FILTER_H)
+#define FILTER_H
+
+#include "hal.h"
+
+/* One filter state per sampled input */
+#define FILTER_CHANNELS             (HAL_CHANNELS)
+
+/* Filter types */
+#define FILTER_TYPE_BOXCAR          (0u)    /* MAX_SAMPLE moving average, 4 bytes of RAM per sample */
+#define FILTER_TYPE_IIR             (1u)    /* single-pole IIR, one accumulator */
+#define FILTER_TYPE_CIC             (2u)    /* CIC decimator followed by a 4-tap FIR */
+#define FILTER_TYPE_ADAPTIVE        (3u)    /* single-pole IIR with a time constant that adapts */
+
+/* Selected filter type, may be overridden on the compiler command line */
+#if !defined(FILTER_TYPE)
+    #define FILTER_TYPE             (FILTER_TYPE_ADAPTIVE)
+#endif /* !defined(FILTER_TYPE) */
+
+/* Threshold value to reset the filter for sharp change in signal, in counts
+* of the 20-bit ADC configuration. Filter_SetProfile() scales it at run time
+* for the lower resolutions (profile.c).
+*/
+#define SIGNAL_SLOPE                1000
+
+/* Boxcar: number of samples to be taken before averaging the ADC value */
+#define MAX_SAMPLE                  ((uint8)128)
+
+/* Boxcar: number of shifts for calculating the sum and average of MAX_SAMPLE */
+#define DIV                         7
+
+/* IIR: time constant of 2^FILTER_IIR_SHIFT samples. 6 gives about the same
+* white noise rejection as the 128 sample boxcar. The accumulator is always
+* scaled by 2^FILTER_IIR_SHIFT; Filter_SetProfile() may shorten the time
+* constant, never lengthen it.
+*/
+#define FILTER_IIR_SHIFT            (6u)
+
+/* Adaptive: the time constant drops to 2^FILTER_ADAPTIVE_MIN_SHIFT samples
+* when the input jumps by more than SIGNAL_SLOPE, and by one octave per
+* sample while the input is more than FILTER_ADAPTIVE_THRESHOLD counts away.
+* It widens again by one octave after each 2^shift quiet samples, up to
+* 2^FILTER_IIR_SHIFT (or the time constant set with Filter_SetProfile()).
+*/
+#define FILTER_ADAPTIVE_MIN_SHIFT   (1u)
+#define FILTER_ADAPTIVE_THRESHOLD(slope)    ((slope) / 4)
+
+/* CIC: number of integrator/comb stages and decimation ratio of
+* 2^FILTER_CIC_DECIMATION_SHIFT samples. The output is updated once per
+* decimated sample.
+*/
+#define FILTER_CIC_ORDER            (3u)
+#define FILTER_CIC_DECIMATION_SHIFT (3u)
+#define FILTER_CIC_DECIMATION       (1u << FILTER_CIC_DECIMATION_SHIFT)
+
+/* CIC gain of R^N, removed before the FIR */
+#define FILTER_CIC_GAIN_SHIFT       (FILTER_CIC_ORDER * FILTER_CIC_DECIMATION_SHIFT)
+
+/* FIR taps {1, 3, 3, 1} sum to 8 */
+#define FILTER_FIR_TAPS             (4u)
+#define FILTER_FIR_GAIN_SHIFT       (3u)
+
+/* The 21-bit ADC range times the IIR or CIC gain must fit in 32 bits */
+#if(FILTER_ADAPTIVE_MIN_SHIFT > FILTER_IIR_SHIFT)
+    #error "FILTER_ADAPTIVE_MIN_SHIFT must not exceed FILTER_IIR_SHIFT"
+#endif /* FILTER_ADAPTIVE_MIN_SHIFT > FILTER_IIR_SHIFT */
+
+#if(FILTER_IIR_SHIFT > 10u)
+    #error "FILTER_IIR_SHIFT is too large for a 32-bit accumulator"
+#endif /* FILTER_IIR_SHIFT > 10u */
+
+#if(FILTER_CIC_GAIN_SHIFT > 10u)
+    #error "CIC order and decimation are too large for 32-bit arithmetic"
+#endif /* FILTER_CIC_GAIN_SHIFT > 10u */
+
+
+/***************************************
+*        Function Prototypes
+***************************************/
+
+void Filter_Init(uint8 channel, int32 sample);
+int32 Filter_Process(uint8 channel, int32 sample);
+int32 Filter_ProcessBlock(uint8 channel, int32 const samples[], uint8 count);
+int32 Filter_GetAverage(uint8 channel);
+void Filter_SetProfile(int32 slope, uint8 tauShift);
+
+#endif /* FILTER_H */
+
+/* [] END OF FILE */
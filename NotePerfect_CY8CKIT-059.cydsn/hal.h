@@ -0,0 +1,54 @@
+/******************************************************************************
+* File Name: hal.h
+*
+* Version 1.0
+*
+* Description:
+* This file contains the hardware abstraction shim of the NotePerfect signal
+* core (notetable.c, filter.c, quantizer.c, scale.c, stats.c). The core
+* only uses the PSoC integer types, the CYCODE flash qualifier and the
+* number of sampled channels, and gets everything else (ADC scaling,
+* samples) through its function arguments. On the target this header pulls them from the
+* generated device headers; built with NOTEPERFECT_HOST defined it maps them
+* onto standard C, so the same core sources compile and run on a PC.
+*
+*******************************************************************************/
+
+#if !defined(HAL_H)
+#define HAL_H
+
+#if defined(NOTEPERFECT_HOST)
+
+    #include <stdint.h>
+
+    typedef uint8_t     uint8;
+    typedef uint16_t    uint16;
+    typedef uint32_t    uint32;
+    typedef uint64_t    uint64;
+    typedef int8_t      int8;
+    typedef int16_t     int16;
+    typedef int32_t     int32;
+    typedef int64_t     int64;
+    typedef char        char8;
+
+    /* Constant tables stay in ordinary memory */
+    #define CYCODE
+
+    /* Number of input channels the core keeps state for */
+    #if !defined(HAL_CHANNELS)
+        #define HAL_CHANNELS    (2u)
+    #endif /* !defined(HAL_CHANNELS) */
+
+#else
+
+    #include <device.h>
+    #include "sampler.h"
+
+    /* Number of input channels the core keeps state for */
+    #define HAL_CHANNELS        (SAMPLER_CHANNELS)
+
+#endif /* defined(NOTEPERFECT_HOST) */
+
+#endif /* HAL_H */
+
+/* [] END OF FILE */
@@ -0,0 +1,291 @@
+/******************************************************************************
+* File Name: idle.c
+*
+* Version 1.0
+*
+* Description:
+* This file contains the low-power idle mode. The main loop reports the
+* filtered input of every channel with Idle_Track() and button presses with
+* Idle_Activity(). Once neither has changed for IDLE_QUIET_SECONDS,
+* Idle_Task() enters idle mode:
+*
+*  - the LCD is put to sleep (display off) and CapSense is stopped,
+*  - the tick interrupt is stopped, so nothing wakes the CPU every 100 us,
+*  - optionally the ADC switches to a slower configuration,
+*  - Idle_Sleep() then halts the CPU (WFI) whenever no conversion is waiting,
+*    so it only runs for one filter/quantizer pass per conversion.
+*
+* The quantizer keeps running on every conversion while idle, and the first
+* filtered value that moves more than IDLE_WAKE_MV from the reference ends
+* idle mode from within the same pass, i.e. one conversion after the input
+* moved.
+*
+*******************************************************************************/
+
+#include "idle.h"
+#include "stdlib.h"
+
+#if(IDLE_ENABLE == 1u)
+
+    /* Input at the last activity, per channel */
+    static int32 reference[SAMPLER_CHANNELS];
+
+    /* Movement in ADC counts that counts as activity */
+    static int32 wakeCounts = 0;
+
+    /* Tick count of the last activity */
+    static uint32 lastActivity = 0u;
+
+    static uint8 idle = 0u;
+
+    static void Idle_Enter(void);
+    static void Idle_Exit(void);
+
+#endif /* IDLE_ENABLE == 1u */
+
+
+/*******************************************************************************
+* Function Name: Idle_Start
+********************************************************************************
+*
+* Summary:
+*  Starts the quiet period. Must be called after the filters are seeded and
+*  Tick_Start(), and again after an ADC profile switch.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void Idle_Start(void)
+{
+#if(IDLE_ENABLE == 1u)
+    uint8 channel;
+
+    for(channel = 0u; channel < SAMPLER_CHANNELS; channel++)
+    {
+        reference[channel] = 0;
+    }
+
+    wakeCounts = (int32)(((int64) ADC_CountsPerVolt * IDLE_WAKE_MV) / 1000);
+    lastActivity = Tick_GetCount();
+    idle = 0u;
+#endif /* IDLE_ENABLE == 1u */
+}
+
+
+/*******************************************************************************
+* Function Name: Idle_Activity
+********************************************************************************
+*
+* Summary:
+*  Restarts the quiet period, e.g. on a button press.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void Idle_Activity(void)
+{
+#if(IDLE_ENABLE == 1u)
+    lastActivity = Tick_GetCount();
+#endif /* IDLE_ENABLE == 1u */
+}
+
+
+/*******************************************************************************
+* Function Name: Idle_Track
+********************************************************************************
+*
+* Summary:
+*  Compares the filtered input of one channel with the value at the last
+*  activity. Movement by more than IDLE_WAKE_MV restarts the quiet period and
+*  ends idle mode.
+*
+* Parameters:
+*  channel:  input channel, 0 .. SAMPLER_CHANNELS - 1
+*  counts:   filtered ADC counts
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void Idle_Track(uint8 channel, int32 counts)
+{
+#if(IDLE_ENABLE == 1u)
+    if(abs(counts - reference[channel]) > wakeCounts)
+    {
+        reference[channel] = counts;
+
+        if(0u != idle)
+        {
+            Idle_Exit();
+        }
+        lastActivity = Tick_GetCount();
+    }
+#else
+    (void) channel;
+    (void) counts;
+#endif /* IDLE_ENABLE == 1u */
+}
+
+
+/*******************************************************************************
+* Function Name: Idle_Task
+********************************************************************************
+*
+* Summary:
+*  Enters idle mode once the quiet period has passed and the LCD has
+*  finished flushing. Called on every main loop pass.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void Idle_Task(void)
+{
+#if(IDLE_ENABLE == 1u)
+    if((0u == idle) && ((Tick_GetCount() - lastActivity) >= IDLE_QUIET_TICKS) &&
+       (0u == LCD_IsFlushing()))
+    {
+        Idle_Enter();
+    }
+#endif /* IDLE_ENABLE == 1u */
+}
+
+
+/*******************************************************************************
+* Function Name: Idle_Sleep
+********************************************************************************
+*
+* Summary:
+*  In idle mode, halts the CPU until the next interrupt unless a conversion
+*  is already waiting. Interrupts are masked around the check so a
+*  conversion that completes in between still ends the WFI. Returns at once
+*  when not idle.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void Idle_Sleep(void)
+{
+#if(IDLE_ENABLE == 1u)
+    if(0u != idle)
+    {
+        CyGlobalIntDisable;
+        if(0u == Sampler_IsPending())
+        {
+            CY_PM_WFI;
+        }
+        CyGlobalIntEnable;
+    }
+#endif /* IDLE_ENABLE == 1u */
+}
+
+
+/*******************************************************************************
+* Function Name: Idle_IsIdle
+********************************************************************************
+*
+* Summary:
+*  Reports whether idle mode is active. The main loop skips the button and
+*  display tasks while idle.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  Non-zero while idle.
+*
+*******************************************************************************/
+uint8 Idle_IsIdle(void)
+{
+#if(IDLE_ENABLE == 1u)
+    return idle;
+#else
+    return 0u;
+#endif /* IDLE_ENABLE == 1u */
+}
+
+
+#if(IDLE_ENABLE == 1u)
+
+    /*******************************************************************************
+    * Function Name: Idle_Enter
+    ********************************************************************************
+    *
+    * Summary:
+    *  Puts the front panel to sleep, stops the tick and slows the ADC down.
+    *
+    * Parameters:
+    *  None.
+    *
+    * Return:
+    *  None.
+    *
+    *******************************************************************************/
+    static void Idle_Enter(void)
+    {
+        LCD_Sleep();
+        Buttons_Sleep();
+        Tick_Suspend();
+
+    #if(IDLE_ADC_CONFIG != 0u)
+        if(IDLE_ADC_RUN_CONFIG == Profile_GetAdcConfig())
+        {
+            Profile_SetAdcConfig(IDLE_ADC_CONFIG);
+        }
+    #endif /* IDLE_ADC_CONFIG != 0u */
+
+        idle = 1u;
+    }
+
+
+    /*******************************************************************************
+    * Function Name: Idle_Exit
+    ********************************************************************************
+    *
+    * Summary:
+    *  Restores the full conversion rate first, then the tick and the
+    *  buttons. The LCD is turned on later by the display task (see
+    *  Display_Wakeup()), as this runs from the sample task and the
+    *  background flush resumes with the tick.
+    *
+    * Parameters:
+    *  None.
+    *
+    * Return:
+    *  None.
+    *
+    *******************************************************************************/
+    static void Idle_Exit(void)
+    {
+    #if(IDLE_ADC_CONFIG != 0u)
+        if(IDLE_ADC_RUN_CONFIG == Profile_GetAdcConfig())
+        {
+            Profile_SetAdcConfig(IDLE_ADC_RUN_CONFIG);
+        }
+    #endif /* IDLE_ADC_CONFIG != 0u */
+
+        Tick_Resume();
+        Buttons_Wakeup();
+        Display_Wakeup();
+
+        idle = 0u;
+    }
+
+#endif /* IDLE_ENABLE == 1u */
+
+/* [] END OF FILE */
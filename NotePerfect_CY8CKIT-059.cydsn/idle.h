@@ -0,0 +1,57 @@
+/******************************************************************************
+* File Name: idle.h
+*
+* Version 1.0
+*
+* Description:
+* This file contains the constants and function prototypes of the low-power
+* idle mode entered while the input CV is static.
+*
+*******************************************************************************/
+
+#if !defined(IDLE_H)
+#define IDLE_H
+
+#include <device.h>
+#include "sampler.h"
+#include "tick.h"
+#include "buttons.h"
+#include "profile.h"
+#include "display.h"
+
+/* 1 = enter idle mode after IDLE_QUIET_SECONDS without input movement or
+* button presses. The LCD is blank and the buttons are not scanned while
+* idle; moving the CV wakes it up.
+*/
+#define IDLE_ENABLE                 (0u)
+
+/* Quiet period before idle mode */
+#define IDLE_QUIET_SECONDS          (60u)
+#define IDLE_QUIET_TICKS            (IDLE_QUIET_SECONDS * 1000u * TICKS_PER_MS)
+
+/* Input movement (in mV) that counts as activity and ends idle mode */
+#define IDLE_WAKE_MV                (10)
+
+/* ADC configuration used while idle, 0 = keep the running one. The idle
+* configuration must have the same resolution and range as configuration 1
+* and only a lower conversion rate, so the counts stay comparable; it is
+* only used while that configuration runs (PROFILE_PRECISE, profile.h).
+*/
+#define IDLE_ADC_CONFIG             (0u)
+#define IDLE_ADC_RUN_CONFIG         (1u)
+
+
+/***************************************
+*        Function Prototypes
+***************************************/
+
+void Idle_Start(void);
+void Idle_Activity(void);
+void Idle_Track(uint8 channel, int32 counts);
+void Idle_Task(void);
+void Idle_Sleep(void);
+uint8 Idle_IsIdle(void);
+
+#endif /* IDLE_H */
+
+/* [] END OF FILE */
@@ -0,0 +1,201 @@
+/******************************************************************************
+* File Name: leds.c
+*
+* Version 1.0
+*
+* Description:
+* This file contains the front panel LED manager. Red shows that In_A is
+* active and green In_B, with a brightness that follows the note; blue shows
+* that a correction is being applied.
+*
+* The manager keeps the state it last wrote to the LED PWMs and Control_Reg
+* and only touches the hardware on a real transition, so the main loop can
+* report the LED state for every sample without paying for the register
+* writes: the blue reset/stop sequence, for instance, runs once when the
+* correction ends instead of on every sample. Control_Reg only holds the
+* LED reset bits, which are released right after the PWM is stopped, so it
+* is written without a read-modify-write.
+*
+* Brightness comes from Leds_Gamma[], computed at compile time from
+* LEDS_GAMMA() and placed in flash, so equal note steps look like equal
+* brightness steps.
+*
+*******************************************************************************/
+
+#include "leds.h"
+
+/* Compare value not written yet, forces the next write */
+#define LEDS_LEVEL_UNKNOWN          (0xFFFFu)
+
+/* Gamma-corrected LED compare value of each step */
+uint16 const CYCODE Leds_Gamma[NOTE_TABLE_SIZE] =
+{
+    NOTE_ROW_64(LEDS_GAMMA, 0u), NOTE_ROW_64(LEDS_GAMMA, 64u)
+};
+
+/* Input shown by the red or green LED, and its compare value */
+static uint8 activeInput = IN_A;
+static uint16 inputLevel = LEDS_LEVEL_UNKNOWN;
+
+/* Blue LED running, and its compare value */
+static uint8 blueOn = 0u;
+static uint16 blueLevel = LEDS_LEVEL_UNKNOWN;
+
+
+
+/*******************************************************************************
+* Function Name: Leds_Start
+********************************************************************************
+*
+* Summary:
+*  Starts the red LED for In_A, with blue off.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void Leds_Start(void)
+{
+    Control_Reg_Write(LEDS_CTRL_RUN);
+
+    PWM_Red_Start(); /* start IN_A PWM */
+
+    activeInput = IN_A;
+    inputLevel = LEDS_LEVEL_UNKNOWN;
+    blueOn = 0u;
+    blueLevel = LEDS_LEVEL_UNKNOWN;
+}
+
+
+/*******************************************************************************
+* Function Name: Leds_SelectInput
+********************************************************************************
+*
+* Summary:
+*  Switches to the LED of an input: red for In_A, green for In_B. Nothing is
+*  written if the input is already shown. The new LED keeps its old
+*  brightness until the next Leds_ShowNote().
+*
+* Parameters:
+*  input:  IN_A or IN_B
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void Leds_SelectInput(uint8 input)
+{
+    if(input == activeInput)
+    {
+        return;
+    }
+
+    if(IN_A == input)
+    {
+        /* start Red LED pwm and stop Green */
+        PWM_Red_Start();
+        Control_Reg_Write(LEDS_GREEN_CTRL);
+        PWM_Green_Stop();
+    }
+    else
+    {
+        /* start Green LED pwm and stop Red */
+        PWM_Green_Start();
+        Control_Reg_Write(LEDS_RED_CTRL);
+        PWM_Red_Stop();
+    }
+    Control_Reg_Write(LEDS_CTRL_RUN);
+
+    activeInput = input;
+    inputLevel = LEDS_LEVEL_UNKNOWN;
+}
+
+
+/*******************************************************************************
+* Function Name: Leds_ShowNote
+********************************************************************************
+*
+* Summary:
+*  Sets the brightness of the input LED to the level of a note. The PWM is
+*  only written if the level changes.
+*
+* Parameters:
+*  note:  NotePerfect step number, 0 .. NOTE_TABLE_SIZE - 1
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void Leds_ShowNote(uint32 note)
+{
+    uint16 level = Leds_Gamma[note];
+
+    if(level != inputLevel)
+    {
+        if(IN_A == activeInput)
+        {
+            PWM_Red_WriteCompare(level);
+        }
+        else
+        {
+            PWM_Green_WriteCompare(level);
+        }
+        inputLevel = level;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: Leds_ShowCorrection
+********************************************************************************
+*
+* Summary:
+*  Turns the blue LED on, with a brightness that follows the note, while a
+*  correction is applied and off otherwise. Called for every sample; does
+*  nothing unless the state or the level changes.
+*
+* Parameters:
+*  corrected:  non-zero if the output note differs from the input
+*  note:       NotePerfect step number, 0 .. NOTE_TABLE_SIZE - 1
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void Leds_ShowCorrection(uint8 corrected, uint32 note)
+{
+    uint16 level;
+
+    if(0u != corrected)
+    {
+        level = Leds_Gamma[(note > LEDS_BLUE_MAX_STEP) ? LEDS_BLUE_MAX_STEP : note];
+
+        if(level != blueLevel)
+        {
+            PWM_Blue_WriteCompare(level);
+            blueLevel = level;
+        }
+        if(0u == blueOn)
+        {
+            PWM_Blue_Start();
+            blueOn = 1u;
+        }
+    }
+    else if(0u != blueOn)
+    {
+        /* Fixed-function PWMs hold value when stopped, so reset first then stop */
+        Control_Reg_Write(LEDS_BLUE_CTRL);
+        PWM_Blue_Stop();
+        Control_Reg_Write(LEDS_CTRL_RUN);
+        blueOn = 0u;
+    }
+    else
+    {
+        /* already off */
+    }
+}
+
+/* [] END OF FILE */
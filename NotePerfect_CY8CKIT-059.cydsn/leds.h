@@ -0,0 +1,58 @@
+/******************************************************************************
+* File Name: leds.h
+*
+* Version 1.0
+*
+* Description:
+* This file contains the constants, brightness table and function
+* prototypes of the front panel tri-color LED.
+*
+*******************************************************************************/
+
+#if !defined(LEDS_H)
+#define LEDS_H
+
+#include <device.h>
+#include "notetable.h"
+
+/* Control_Reg bits holding the LED PWMs in reset, and no reset */
+#define LEDS_CTRL_RUN               (0x00u)
+#define LEDS_BLUE_CTRL              (0x01u)
+#define LEDS_RED_CTRL               (0x02u)
+#define LEDS_GREEN_CTRL             (0x04u)
+
+/* Compare value of a fully lit LED (same period as the CV output PWM) */
+#define LEDS_FULL_SCALE             (MAX_CONTROL_VOLTAGE * PWM_COUNTS_PER_VOLT)
+
+/* Dimmest level, so the input LED never goes all the way off */
+#define LEDS_LEVEL_MIN              (50u)
+
+/* Blue LED brightness is limited to the level of this step (arbitrary) */
+#define LEDS_BLUE_MAX_STEP          (10u)
+
+/* Brightness of step n with a gamma of about 2.2, approximated by
+* (4x^2 + x^3) / 5 so the table can be computed by the preprocessor.
+*/
+#define LEDS_GAMMA(n)               ((uint16)(((n) < NUMBER_NOTE_PERFECT_STEPS) ? \
+                                    (LEDS_LEVEL_MIN + (((uint64)(LEDS_FULL_SCALE - LEDS_LEVEL_MIN) * \
+                                      ((4u * (n) * (n) * NUMBER_NOTE_PERFECT_STEPS) + ((n) * (n) * (n)))) / \
+                                     (5u * (uint64) NUMBER_NOTE_PERFECT_STEPS * NUMBER_NOTE_PERFECT_STEPS * \
+                                      NUMBER_NOTE_PERFECT_STEPS))) : \
+                                    LEDS_FULL_SCALE))
+
+
+/***************************************
+*        Function Prototypes
+***************************************/
+
+void Leds_Start(void);
+void Leds_SelectInput(uint8 input);
+void Leds_ShowNote(uint32 note);
+void Leds_ShowCorrection(uint8 corrected, uint32 note);
+
+/* Gamma-corrected LED compare value of each step */
+extern uint16 const CYCODE Leds_Gamma[NOTE_TABLE_SIZE];
+
+#endif /* LEDS_H */
+
+/* [] END OF FILE */
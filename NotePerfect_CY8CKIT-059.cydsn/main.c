@@ -28,15 +28,19 @@
 * This project is based on the PSoC 5LP code example for the DelSigADC:
 * C:\Program Files (x86)\Cypress\PSoC 5LP Development Kit\1.0\Firmware\VoltageDisplay_DelSigADC
 * The DelSigADC is configured for 20-bit resolution to measure the input
-* voltage with high accuracy. A moving-average filter of 128 samples is
-* applied to the ADC conversion before using the result in NotePerfect
-* calculations and displaying the result (in micro volts) on the LCD.
+* voltage with high accuracy. A low-pass filter (filter.c) is applied to
+* the ADC conversions before using the result in NotePerfect calculations
+* and displaying the result on the LCD.
 *
 * NotePerfect output voltages are determined by calculating the nearest
 * "step" (0V - 5V) and then using the step number as an index into a lookup 
 * table for PWM compare values. Full-scale voltage, number of notes per
-* volt and correction window are determined by #defines at the top of
-* main.c.
+* volt and correction window are determined by #defines in notetable.h.
+*
+* main.c starts the modules and runs them from a cooperative scheduler
+* (sched.c): the sample, quantize and output tasks pass each batch of
+* conversions along, and the button, LCD and telemetry tasks run between
+* batches. Each module and its options are described in its own file.
 * 
 * There are two input channels (In_A and In_B) seleced via Analog Mux
 * using front-panel CapSense touch buttons:
@@ -54,332 +58,591 @@
 *  - Blue indicates a correction is being applied to the incoming voltage.
 *
 * Three CapSense buttons on the front panel control/select which input
-* is active (In_A or In_B), Misc button is for future use.
+* is active (In_A or In_B). The Misc button steps through the scales, or
+* through the LCD pages while In A or In B is held; a long press selects
+* the next ADC profile (PROFILE_ENABLE). In A and In B pressed together
+* enter calibration mode (CALIB_ENABLE). With SAMPLER_ROUND_ROBIN both
+* inputs are quantized at once and In A/In B only choose the channel shown
+* on the LCD and LEDs.
 * 
 * 
 *******************************************************************************/
 #include <device.h>
-#include "stdio.h"
-#include "stdlib.h"
+#include "sampler.h"
+#include "filter.h"
+#include "tick.h"
+#include "display.h"
+#include "notetable.h"
+#include "quantizer.h"
+#include "scale.h"
+#include "output.h"
+#include "perf.h"
+#include "buttons.h"
+#include "trigger.h"
+#include "calib.h"
+#include "idle.h"
+#include "leds.h"
+#include "stats.h"
+#include "telemetry.h"
+#include "midi.h"
+#include "profile.h"
+#include "sched.h"
+#include "stddef.h"
+
+#define LED_OFF     (0u)
+#define LED_ON      (1u)
 
-#define IN_B (0u)
-#define IN_A  (1u)
+/* Stage of the conversions in flight: the sample task filters a batch, the
+* quantize task turns it into a note and the output task puts it out */
+#define MAIN_CV_IDLE        (0u)
+#define MAIN_CV_FILTERED    (1u)
+#define MAIN_CV_QUANTIZED   (2u)
 
-/* Number of samples to be taken before averaging the ADC value */
-#define MAX_SAMPLE                  ((uint8)128)
+/* SysTick ticks between two runs of the telemetry task, which has no period
+* of its own; the UI and display tasks run at BUTTONS_PERIOD_TICKS and
+* DISPLAY_PERIOD_TICKS */
+#define MAIN_TELEMETRY_TICKS (1u)
 
-/* Threshold value to reset the filter for sharp change in signal */
-#define SIGNAL_SLOPE                1000
+#if(SAMPLER_USE_DMA == 1u)
+    /* Completed DMA block of ADC conversions */
+    static int32 const * samples;
+#else
+    /* Batch of ADC conversions drained from the sample ring */
+    static int32 samples[SAMPLER_BATCH_SIZE];
+#endif /* SAMPLER_USE_DMA == 1u */
+static uint8 sampleCount = 0u;
 
-/* Number of shifts for calculating the sum and average of MAX_SAMPLE */
-#define DIV                         7
+/* Variable to hold the filtered value */
+static int32 averageCounts = 0;
 
-/* Number of "NotePerfect" control voltages per volt */
-#define NUMBER_NOTES_PER_VOLT       (12u)
+/* Variables to calculate and hold NotePerfect DAC value, per channel */
+static uint32 notePerfectValue = 0;
+static uint32 previousNotePerfectValue[SAMPLER_CHANNELS];
 
-/* Maximum control voltage */
-#define MAX_CONTROL_VOLTAGE         (5u)
+/* Distance of the input from the chosen step (fraction of a step) */
+static int32 quantizerError = 0;
 
-/* Total number of "NotePerfect" quantized steps/values (60) */
-#define NUMBER_NOTE_PERFECT_STEPS (NUMBER_NOTES_PER_VOLT * MAX_CONTROL_VOLTAGE)
+/* Nearest chromatic step, before snapping to the selected scale */
+static uint32 chromaticStep = 0;
 
-/* NotePerfect step size (in mV) */
-#define NOTEPERFECT_STEP_SIZE_MV    ((MAX_CONTROL_VOLTAGE * 1000) / NUMBER_NOTE_PERFECT_STEPS)
+static uint8_t inputChannel = IN_A;
 
-/* Correction window (in mV) */
-#define CORRECTION_WINDOW           (NOTEPERFECT_STEP_SIZE_MV / 4)
+/* Sampler/filter channel being processed, and the one on the front panel */
+static uint8 channel = 0u;
+static uint8 panelChannel = SAMPLER_CHANNEL(IN_A);
 
-/* Define constants for capsense buttons */
-#define ON           (1)
-#define OFF          (0)
+#if(SAMPLER_USE_DMA == 0u)
+    /* Channel the sample task looks at first */
+    static uint8 nextChannel = 0u;
+#endif /* SAMPLER_USE_DMA == 0u */
 
-#define LED_OFF     (0u)
-#define LED_ON      (1u)
+/* MAIN_CV_* of channel */
+static uint8 cvStage = MAIN_CV_IDLE;
 
-/* control register masks */
-#define BLUE_CTRL   (0x01)
-#define RED_CTRL    (0x02)
-#define GREEN_CTRL  (0x04)
+#if(TRIGGER_ENABLE == 1u)
+    /* Trigger edges already sent as MIDI */
+    static uint32 midiEdges = 0u;
+#endif /* TRIGGER_ENABLE == 1u */
 
-/* NotePerfect step number lookup table */
-uint16_t PWM_Lookup[] = {0, 83, 167, 250, 333, 417, 500, 583, 667, 750, 833, 917, 1000,
-                            1083, 1167, 1250, 1333, 1417, 1500, 1583, 1667, 1750, 1833, 1917, 2000,
-                            2083, 2167, 2250, 2333, 2417, 2500, 2583, 2667, 2750, 2833, 2917, 3000,
-                            3083, 3167, 3250, 3333, 3417, 3500, 3583, 3667, 3750, 3833, 3917, 4000,
-                            4083, 4167, 4250, 4333, 4417, 4500, 4583, 4667, 4750, 4833, 4917, 5000};
+static void Main_SampleTask(void);
+static uint8 Main_SampleReady(void);
+static void Main_QuantizeTask(void);
+static uint8 Main_QuantizeReady(void);
+static void Main_OutputTask(void);
+static uint8 Main_OutputReady(void);
+static void Main_UiTask(void);
+static void Main_DisplayTask(void);
+
+/* Tasks, highest priority first: a note in flight is finished before new
+* conversions are read, and the front panel only runs between notes */
+static Sched_TASK const Main_Tasks[] =
+{
+    { &Main_OutputTask,   &Main_OutputReady,   0u },
+    { &Main_QuantizeTask, &Main_QuantizeReady, 0u },
+    { &Main_SampleTask,   &Main_SampleReady,   0u },
+    { &Main_UiTask,       NULL,                BUTTONS_PERIOD_TICKS },
+    { &Main_DisplayTask,  NULL,                DISPLAY_PERIOD_TICKS },
+    { &Telemetry_Task,    NULL,                MAIN_TELEMETRY_TICKS },
+};
 
 int main(void)
 {
+    /* Channel being initialized */
     uint8 i;
     
-    /* Array to store ADC count for moving average filter */
-    int32 adcCounts[MAX_SAMPLE] = {0};
+    CYGlobalIntEnable;
     
-    /* Variable to hold ADC conversion result */
-    int32 result = 0;
+    /* The CV path comes up first so the output carries a valid note as soon
+     * as the first conversion is in; the front panel follows. */
     
-    /* Variable to store accumulated sample for filter array */
-    int32 sum = 0;
+    /* start and initialize Analog input Mux to IN_A as the source
+     * (in round-robin mode the sampler switches it from here on) */
+    myMux_Start();
+    myMux_FastSelect(IN_A);
+
+    /* Start ADC, load the calibration (one EEPROM block read), hook the
+     * sampling ISR, start conversion and switch to the saved ADC profile */
+    ADC_Start();
+    (void) Calib_Load();
+    Sampler_Start();
+    ADC_StartConvert();
+    Profile_Start();
     
-    /* Variable for testing sharp change in signal slope */
-    int16 diff = 0;
+    /* start Opamp and PWM */
+    Opamp_Start();
+    Output_Start();
+    Trigger_Start();
+    Midi_Start();
     
-    /* Variable to hold the result in milli volts converted from filtered 
-     * ADC counts */
-    int32 milliVolts = 0;
-	
-    /* Variable to hold the moving average filtered value */
-    int32 averageCounts = 0;
-	
-    /* Index variable to work on the filter array */
-    uint8 index = 0;
+    /* Power up with every note allowed */
+    Scale_Select(SCALE_CHROMATIC);
     
-    /* Variables to calculate and hold NotePerfect DAC value */
-    uint32 notePerfectValue = 0;
-    uint32 previousNotePerfectValue = 0;
-    uint32 remainder = 0;
+    /* Read one sample from the ADC, initialize the filter of each channel
+     * and put its note out at once */
+    for(i = 0u; i < SAMPLER_CHANNELS; i++)
+    {
+        Filter_Init(i, Sampler_WaitSample(i));
+        chromaticStep = Quantizer_Quantize(Filter_GetAverage(i), &quantizerError);
+        notePerfectValue = Quantizer_Hold(i, Scale_Snap(chromaticStep, quantizerError),
+                                          chromaticStep, quantizerError);
+#if(TRIGGER_ENABLE == 1u)
+        Trigger_Arm(i, notePerfectValue);
+#else
+        Output_WriteNote(i, notePerfectValue);
+#endif /* TRIGGER_ENABLE == 1u */
+        previousNotePerfectValue[i] = NOTE_TABLE_SIZE; /* LEDs are set by the first pass */
+    }
     
-    /* Character array to hold the micro volts*/
-    char displayStr[15] = {'\0'};
+    /* Average count is equal to one single sample for first ADC reading */
+    averageCounts = Filter_GetAverage(panelChannel);
     
-    uint8_t previousButton0 = OFF, previousButton1 = OFF;
-//    uint8_t previousButton2 = OFF;
-    uint8_t inputChannel = IN_A;
-
-    CYGlobalIntEnable;
+    /* Start the tick, then the LCD: its init sequence (about 90 ms of
+     * delays) is clocked out by the tick in the background */
+    Tick_Start();
+    LCD_StartBackground();
+    Display_Start();
+    Display_SetScale(Scale_GetName(SCALE_CHROMATIC));
+    Display_SetProfile(Profile_GetTag(Profile_GetSelected()));
     
+    /* LCD contrast and IN_A LED */
     VDAC8_Start();
     Opamp_1_Start();
-    PWM_Red_Start(); /* start IN_A PWM */
+    Leds_Start();
     
     /* Start capsense and initialize baselines and enable scan */
-    CapSense_Start();
-    CapSense_InitializeAllBaselines();
+    Buttons_Start();
+    
+    /* initialize indicator LEDs */
+    LED3_Write(LED_ON);
+    
+    /* start the quiet period of the idle mode (IDLE_ENABLE) */
+    Idle_Start();
+    
+    /* start the sample stream (TELEMETRY_ENABLE) */
+    Telemetry_Start();
+    
+    /* start the cycle counter of the loop instrumentation (PERF_ENABLE) */
+    Perf_Start();
+    
+    Sched_Start(Main_Tasks, (uint8)(sizeof(Main_Tasks) / sizeof(Main_Tasks[0])));
 
-    /* Start ADC and start conversion */
-    ADC_Start();
-    ADC_StartConvert();
+    while(1)
+    {
+        PERF_BEGIN(PERF_STAGE_LOOP);
+        
+        /* run the most urgent task; with nothing to do, enter idle mode
+         * after the quiet period, then halt the CPU until the next
+         * conversion */
+        if(SCHED_NONE == Sched_RunNext())
+        {
+            Idle_Task();
+            Idle_Sleep();
+        }
+        
+        PERF_END(PERF_STAGE_LOOP);
+    }
+}
 
-    /* Start LCD and set position */
-    LCD_Start();
-    LCD_Position(0,0);
-    LCD_PrintString("In A     Step=");
 
-    /* Print mV unit on the LCD */
-    LCD_Position(1,4);
-    LCD_PutChar('m');
-    LCD_PutChar('V');
-    LCD_Position(1,8);
-    LCD_PrintString("DAC=");
-    
-    /* Read one sample from the ADC and initialize the filter */
-    ADC_IsEndConversion(ADC_WAIT_FOR_RESULT);
-    result = ADC_GetResult32();
+/*******************************************************************************
+* Function Name: Main_SampleTask
+********************************************************************************
+*
+* Summary:
+*  Filters the conversions of the next channel that has new ones. Channels
+*  are visited in turn so a busy one cannot starve the other.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+static void Main_SampleTask(void)
+{
+#if(SAMPLER_USE_DMA == 1u)
+    /* filter the whole block DMA completed since the last pass */
+    PERF_BEGIN(PERF_STAGE_ADC_WAIT);
+    samples = Sampler_GetBlock();
+    PERF_END(PERF_STAGE_ADC_WAIT);
+    if(NULL == samples)
+    {
+        return; /* nothing new to quantize */
+    }
+    channel = SAMPLER_CHANNEL(IN_A);
+    PERF_BEGIN(PERF_STAGE_FILTER);
+    sampleCount = SAMPLER_BLOCK_SIZE;
+    averageCounts = Filter_ProcessBlock(channel, samples, sampleCount);
+    PERF_END(PERF_STAGE_FILTER);
+    /* the block is released once the quantize task has posted it */
+#else
+    uint8 i;
     
-    for(i = 0; i < MAX_SAMPLE; i++)
+    /* drain the conversions collected by the ADC ISR since the last pass */
+    PERF_BEGIN(PERF_STAGE_ADC_WAIT);
+    sampleCount = 0u;
+    for(i = 0u; (i < SAMPLER_CHANNELS) && (0u == sampleCount); i++)
     {
-        adcCounts[i] = result;
+        channel = nextChannel;
+        nextChannel = (uint8)((nextChannel + 1u) % SAMPLER_CHANNELS);
+        sampleCount = Sampler_Read(channel, samples, SAMPLER_BATCH_SIZE);
     }
+    PERF_END(PERF_STAGE_ADC_WAIT);
+    if(0u == sampleCount)
+    {
+        return; /* nothing new to quantize */
+    }
+    PERF_BEGIN(PERF_STAGE_FILTER);
+    averageCounts = Filter_ProcessBlock(channel, samples, sampleCount);
+    PERF_END(PERF_STAGE_FILTER);
+#endif /* SAMPLER_USE_DMA == 1u */
     
-    /* Store sum of 128 samples*/
-    sum = result << DIV;
+    /* input movement restarts the quiet period and ends idle mode */
+    Idle_Track(channel, averageCounts);
     
-    /* Average count is equal to one single sample for first ADC reading */
-    averageCounts = result;
+    cvStage = MAIN_CV_FILTERED;
+}
+
+
+/*******************************************************************************
+* Function Name: Main_SampleReady
+********************************************************************************
+*
+* Summary:
+*  Ready function of the sample task.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  Non-zero if no note is in flight and the sampler has new conversions.
+*
+*******************************************************************************/
+static uint8 Main_SampleReady(void)
+{
+    return ((MAIN_CV_IDLE == cvStage) && (0u != Sampler_IsPending())) ? 1u : 0u;
+}
+
+
+/*******************************************************************************
+* Function Name: Main_QuantizeTask
+********************************************************************************
+*
+* Summary:
+*  Turns the filtered counts into the note of the selected scale and records
+*  it for the statistics and the telemetry stream. In DMA mode the block is
+*  released here, after the telemetry has read it.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+static void Main_QuantizeTask(void)
+{
+    /* NotePerfect magic happens here ... nearest step, no division */
+    PERF_BEGIN(PERF_STAGE_QUANTIZE);
+    chromaticStep = Quantizer_Quantize(averageCounts, &quantizerError);
     
-    /* start Opamp and PWM */
-    Opamp_Start();
-    PWM_Start();
+    /* ... then move it onto the selected scale (single table read) and
+     * hold the previous note until the input is clearly past the boundary */
+    notePerfectValue = Quantizer_Hold(channel, Scale_Snap(chromaticStep, quantizerError),
+                                      chromaticStep, quantizerError);
+    Stats_Record(channel, notePerfectValue, chromaticStep, quantizerError);
     
-    /* initialize indicator LEDs */
-    LED3_Write(LED_ON);
+    /* queue the raw conversions, filter output and step for the UART */
+    Telemetry_Post(channel, samples, sampleCount, averageCounts, notePerfectValue);
+#if(SAMPLER_USE_DMA == 1u)
+    Sampler_ReleaseBlock(); /* Telemetry_Post() has copied what it keeps */
+#endif /* SAMPLER_USE_DMA == 1u */
+    PERF_END(PERF_STAGE_QUANTIZE);
     
-    /* start and initialize Analog input Mux to IN_A as the source */
-    myMux_Start();
-    myMux_FastSelect(IN_A);
+    cvStage = MAIN_CV_QUANTIZED;
+}
 
-    while(1)
+
+/*******************************************************************************
+* Function Name: Main_QuantizeReady
+********************************************************************************
+*
+* Summary:
+*  Ready function of the quantize task.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  Non-zero if filtered counts are waiting.
+*
+*******************************************************************************/
+static uint8 Main_QuantizeReady(void)
+{
+    return (MAIN_CV_FILTERED == cvStage) ? 1u : 0u;
+}
+
+
+/*******************************************************************************
+* Function Name: Main_OutputTask
+********************************************************************************
+*
+* Summary:
+*  Puts a new note out on the PWM and MIDI, or arms it for the next trigger
+*  and sends the notes of the trigger edges since the last run as MIDI, and
+*  updates the LEDs and the readout for the front panel channel.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+static void Main_OutputTask(void)
+{
+#if(TRIGGER_ENABLE == 1u)
+    uint8 output;
+#endif /* TRIGGER_ENABLE == 1u */
+    
+    cvStage = MAIN_CV_IDLE;
+    
+#if(TRIGGER_ENABLE == 1u)
+    /* MIDI follows the notes the trigger edges latched, not the quantizer */
+    if(Trigger_GetCount() != midiEdges)
+    {
+        midiEdges = Trigger_GetCount();
+        for(output = 0u; output < OUTPUT_CHANNELS; output++)
+        {
+            Midi_SendNote(output, Output_Transpose(Trigger_GetLatched(output))); /* queued, sent by the UART_MIDI ISR */
+        }
+    }
+#endif /* TRIGGER_ENABLE == 1u */
+    
+    if(notePerfectValue != previousNotePerfectValue[channel]) /* only spend time if notePerfect step value has changed */
     {
-        /* user interface stuff ... switch between input sources (IN_A vs IN_B input) */
-        if(CapSense_IsBusy() == 0)
+        PERF_BEGIN(PERF_STAGE_PWM);
+#if(TRIGGER_ENABLE == 1u)
+        Trigger_Arm(channel, notePerfectValue); /* output it on the next trigger edge */
+#else
+        Output_WriteNote(channel, notePerfectValue); /* lookup PWM compare value and update PWM */
+        Midi_SendNote(channel, Output_Transpose(notePerfectValue)); /* queued, sent by the UART_MIDI ISR */
+#endif /* TRIGGER_ENABLE == 1u */
+        PERF_END(PERF_STAGE_PWM);
+        
+        /* front-panel LED housekeeping */
+        PERF_BEGIN(PERF_STAGE_LED);
+        if(channel == panelChannel)
         {
-            /* Update baseline for all the sensors */
-            CapSense_UpdateEnabledBaselines();
-            
-            /* Test if button widgets are active */
-            if(CapSense_CheckIsWidgetActive(CapSense_BUTTON0__BTN))
-            {
-                if(previousButton0 == OFF)
-                {
-                    myMux_FastSelect(IN_A); /* select IN_A as input source */
-                    inputChannel = IN_A;
-                    /* start Red LED pwm and stop Green */
-                    PWM_Red_Start();
-                    Control_Reg_Write((Control_Reg_Read() | GREEN_CTRL));
-                    PWM_Green_Stop();
-                    Control_Reg_Write((Control_Reg_Read() & ~GREEN_CTRL));
-                    /* update LCD */
-                    LCD_Position(0,0);
-                    LCD_PrintString("In A");
-
-                    previousButton0 = ON;
-                }
-            }
-            else
-            {
-                previousButton0 = OFF;
-            }
-            
-            if(CapSense_CheckIsWidgetActive(CapSense_BUTTON1__BTN))
-            {
-                if(previousButton1 == OFF)
-                {
-                    myMux_FastSelect(IN_B); /* select IN_B as input source */
-                    inputChannel = IN_B;
-                    /* start Green LED pwm and stop Red */
-                    PWM_Green_Start();
-                    Control_Reg_Write((Control_Reg_Read() | RED_CTRL));
-                    PWM_Red_Stop();
-                    Control_Reg_Write((Control_Reg_Read() & ~RED_CTRL));
-                    /* update LCD */
-                    LCD_Position(0,0);
-                    LCD_PrintString("In B");
-                    
-                    previousButton1 = ON;
-                }
-            }
-            else
-            {
-                previousButton1 = OFF;
-            }
-            
-            /* future use ... for demo only */
-            if(CapSense_CheckIsWidgetActive(CapSense_BUTTON2__BTN))
-            {
-                PWM_Blue_WriteCompare(5000); /* arbitrary action for demo purpose */
-                PWM_Blue_Start();
-                PWM_Red_WriteCompare(0);
-                PWM_Green_WriteCompare(0);
-            }
-//                
-//                if(previousButton2 == OFF)
-//                {
-//                    previousButton2 = ON;
-//                }
-//            }
-//            else
-//            {
-//                previousButton2 = OFF;
-//            }
-                
-            CapSense_ScanEnabledWidgets();
+            Leds_ShowNote(notePerfectValue); /* LED brightness follows input voltage */
         }
+        PERF_END(PERF_STAGE_LED);
         
-        /* start the ADC conversion and wait for the result */
-        ADC_IsEndConversion(ADC_WAIT_FOR_RESULT);
-        result = ADC_GetResult32();
+        previousNotePerfectValue[channel] = notePerfectValue;
+    }
+    
+    if(channel != panelChannel)
+    {
+        return; /* display and correction LED follow the front panel channel */
+    }
         
-        diff = abs(averageCounts - result); /* calculate instantaneous difference to determine if abrupt change has happened */
+    /* display housekeeping ... latest values, shown by Display_Task() */
+    Display_Post(channel, averageCounts, notePerfectValue, Output_GetCompare(channel));
+    
+    /* determine if correction was applied ... Blue LED, only written when it changes */
+    PERF_BEGIN(PERF_STAGE_LED);
+    Leds_ShowCorrection((quantizerError > QUANTIZER_CORRECTION_WINDOW) ||
+                        (quantizerError < -QUANTIZER_CORRECTION_WINDOW) ||
+                        (notePerfectValue != chromaticStep), notePerfectValue);
+    PERF_END(PERF_STAGE_LED);
+}
+
+
+/*******************************************************************************
+* Function Name: Main_OutputReady
+********************************************************************************
+*
+* Summary:
+*  Ready function of the output task.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  Non-zero if a quantized note is waiting.
+*
+*******************************************************************************/
+static uint8 Main_OutputReady(void)
+{
+    return (MAIN_CV_QUANTIZED == cvStage) ? 1u : 0u;
+}
 
-        /* If sharp change in the signal then reset the filter with the new signal value */
-        if(diff > SIGNAL_SLOPE)
+
+/*******************************************************************************
+* Function Name: Main_UiTask
+********************************************************************************
+*
+* Summary:
+*  Scans the CapSense buttons and acts on their events: input selection,
+*  scale, LCD page, ADC profile and calibration mode. Only runs between
+*  notes, so the filters and outputs can be reseeded here.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+static void Main_UiTask(void)
+{
+    /* Button presses posted by the button task */
+    uint8 buttonEvents;
+    
+    /* user interface stuff ... switch between input sources (IN_A vs IN_B input) */
+    PERF_BEGIN(PERF_STAGE_CAPSENSE);
+    if(0u == Idle_IsIdle()) /* CapSense is asleep in idle mode */
+    {
+        Buttons_Task();
+    }
+    buttonEvents = Buttons_GetEvents();
+    if(0u != buttonEvents)
+    {
+        Idle_Activity();
+    }
+    
+    if(0u != (buttonEvents & BUTTONS_EVENT_IN_A))
+    {
+#if(SAMPLER_ROUND_ROBIN == 0u)
+        myMux_FastSelect(IN_A); /* select IN_A as input source */
+#endif /* SAMPLER_ROUND_ROBIN == 0u */
+        inputChannel = IN_A;
+        panelChannel = SAMPLER_CHANNEL(IN_A);
+        previousNotePerfectValue[panelChannel] = NOTE_TABLE_SIZE; /* force LED update */
+        Leds_SelectInput(inputChannel); /* Red LED on, Green off */
+        /* update LCD */
+        Display_SetInput("In A");
+    }
+    
+    if(0u != (buttonEvents & BUTTONS_EVENT_IN_B))
+    {
+#if(SAMPLER_ROUND_ROBIN == 0u)
+        myMux_FastSelect(IN_B); /* select IN_B as input source */
+#endif /* SAMPLER_ROUND_ROBIN == 0u */
+        inputChannel = IN_B;
+        panelChannel = SAMPLER_CHANNEL(IN_B);
+        previousNotePerfectValue[panelChannel] = NOTE_TABLE_SIZE; /* force LED update */
+        Leds_SelectInput(inputChannel); /* Green LED on, Red off */
+        /* update LCD */
+        Display_SetInput("In B");
+    }
+    
+    /* Misc button ... step through the scales, or with In A or In B held
+     * step to the next LCD page */
+    if(0u != (buttonEvents & BUTTONS_EVENT_MISC))
+    {
+        if(0u != (Buttons_GetHeld() & (BUTTONS_EVENT_IN_A | BUTTONS_EVENT_IN_B)))
         {
-            /* fill the filter array with current value */
-            for(i = 0; i < MAX_SAMPLE; i++)
-            {
-                adcCounts[i] = result;
-            }
-            
-            /* Store sum of 128 samples*/
-            sum = result << DIV;
-    
-            /* Average count is equal to new sample */
-            averageCounts = result;
-            index = 0;
+            Display_NextPage();
         }
-        
-        /* Get moving average */
         else
         {
-            /* Remove the oldest element and add new sample to sum and get the average */
-            sum = sum - adcCounts[index];
-            sum = sum + result;
-            averageCounts = sum >> DIV;
-            
-            /* Remove the oldest sample and store new sample */
-            adcCounts[index] = result;
-            index++;
-            if (index == MAX_SAMPLE)
-            {
-                index = 0;
-            }
+            Display_SetScale(Scale_GetName(Scale_Next()));
+            Stats_Reset(); /* corrections now include the new scale */
         }
+    }
+    
+#if(PROFILE_ENABLE == 1u)
+    /* Misc held ... next ADC profile (resolution against latency), the
+     * filters are reseeded and every note is output again */
+    if(0u != (buttonEvents & BUTTONS_EVENT_MISC_LONG))
+    {
+        uint8 i;
         
-        /* convert ADC counts to milliVolts */
-        milliVolts = ADC_CountsTo_mVolts(averageCounts);
-        
-        /* NotePerfect magic happens here */
-        notePerfectValue = (milliVolts / NOTEPERFECT_STEP_SIZE_MV); /* calculate integer step number */
-        remainder = milliVolts % NOTEPERFECT_STEP_SIZE_MV; /* use modulo to get remainder */
-        if(remainder >= NOTEPERFECT_STEP_SIZE_MV/2) /* determine if round-up is necessary */
-            notePerfectValue += 1;
-        
-        if(notePerfectValue != previousNotePerfectValue) /* only spend time if notePerfect step value has changed */
+        Display_SetProfile(Profile_GetTag(Profile_Next()));
+        Stats_Reset();
+        Idle_Start(); /* wake threshold in the new counts */
+        for(i = 0u; i < SAMPLER_CHANNELS; i++)
         {
-            PWM_WriteCompare(PWM_Lookup[notePerfectValue]); /* lookup PWM compare value and update PWM */
-            
-            /* front-panel LED housekeeping */
-            if(IN_A == inputChannel)
-            {
-                if(0 == notePerfectValue) /* don't let indicator LED go all the way off (i.e. PWM to zero) */
-                    PWM_Red_WriteCompare(PWM_Lookup[1]);
-                else
-                    PWM_Red_WriteCompare(PWM_Lookup[notePerfectValue]); /* LED brightness follows input voltage */
-            }
-            else if(IN_B == inputChannel)
-            {
-                if(0 == notePerfectValue) /* don't let indicator LED go all the way off (i.e. PWM to zero) */
-                    PWM_Green_WriteCompare(PWM_Lookup[1]);
-                else
-                    PWM_Green_WriteCompare(PWM_Lookup[notePerfectValue]); /* LED brightness follows input voltage */
-            }
-            
-            /* display housekeeping */
-            sprintf(displayStr, "%4d", PWM_Lookup[notePerfectValue]);
-            LCD_Position(1,12);
-            LCD_PrintString(displayStr);   
-            
-            /* Convert notePerfectValue to string and display on the LCD */
-            sprintf(displayStr, "%2ld", notePerfectValue);
-            LCD_Position(0,14);
-            LCD_PrintString(displayStr);
-            
-            previousNotePerfectValue = notePerfectValue;
+            previousNotePerfectValue[i] = NOTE_TABLE_SIZE;
         }
-            
-        /* Convert milli volts to string and display on the LCD */
-        sprintf(displayStr, "%4ld", milliVolts);
-        LCD_Position(1,0);
-        LCD_PrintString(displayStr);
+    }
+#endif /* PROFILE_ENABLE == 1u */
+    
+#if(CALIB_ENABLE == 1u)
+    /* In A and In B together ... calibration mode, output patched to In_B */
+    if(0u != (buttonEvents & BUTTONS_EVENT_IN_AB))
+    {
+        uint8 profile = Profile_GetSelected();
+        uint8 i;
         
-        /* determine if correction was applied */
-        if((uint32_t) milliVolts > PWM_Lookup[notePerfectValue] + CORRECTION_WINDOW || //
-                            (uint32_t) milliVolts < PWM_Lookup[notePerfectValue] - CORRECTION_WINDOW)
-        {
-            if(notePerfectValue > 10) /* limit Blue LED brightness to step 10 value (arbitrary) */
-                PWM_Blue_WriteCompare(PWM_Lookup[10]);
-            else PWM_Blue_WriteCompare(PWM_Lookup[notePerfectValue]); /* Blue LED brightness follows input voltage */
-            PWM_Blue_Start(); /* Blue LED indicates correction has been applied */
-        }
-        else
+        /* measured on the 20-bit configuration the record refers to */
+        Profile_Select(PROFILE_PRECISE);
+        (void) Calib_Run();
+        Profile_Select(profile);
+        Buttons_Clear(); /* presses on the way out of calibration mode */
+        
+        /* restore input, display and every output through the (new) table */
+#if(SAMPLER_ROUND_ROBIN == 0u)
+        myMux_FastSelect(inputChannel);
+#endif /* SAMPLER_ROUND_ROBIN == 0u */
+        Display_Start();
+        Display_SetInput((IN_A == inputChannel) ? "In A" : "In B");
+        Display_SetScale(Scale_GetName(Scale_GetSelected()));
+        Display_SetProfile(Profile_GetTag(Profile_GetSelected()));
+        for(i = 0u; i < SAMPLER_CHANNELS; i++)
         {
-            /* Fixed-function PWMs hold value when stopped, so reset first then stop */
-            Control_Reg_Write((Control_Reg_Read() | BLUE_CTRL));
-            PWM_Blue_Stop();
-            Control_Reg_Write((Control_Reg_Read() & ~BLUE_CTRL));
+            previousNotePerfectValue[i] = NOTE_TABLE_SIZE;
         }
     }
+#endif /* CALIB_ENABLE == 1u */
+    PERF_END(PERF_STAGE_CAPSENSE);
 }
 
-/* [] END OF FILE */
 
+/*******************************************************************************
+* Function Name: Main_DisplayTask
+********************************************************************************
+*
+* Summary:
+*  Refreshes the LCD at its own (slow) rate, see Display_Task().
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+static void Main_DisplayTask(void)
+{
+    PERF_BEGIN(PERF_STAGE_LCD);
+    if(0u == Idle_IsIdle()) /* the LCD is asleep in idle mode */
+    {
+        Display_Task();
+    }
+    PERF_END(PERF_STAGE_LCD);
+}
+
+/* [] END OF FILE */
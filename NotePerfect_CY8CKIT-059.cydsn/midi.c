@@ -0,0 +1,248 @@
+/******************************************************************************
+* File Name: midi.c
+*
+* Version 1.0
+*
+* Description:
+* This file contains the MIDI note output. When the quantized step of a
+* channel changes, Midi_SendNote() queues a Note Off for the old note and a
+* Note On for the new one (step + MIDI_NOTE_OFFSET), so the module also
+* works as a CV-to-MIDI converter. With TRIGGER_ENABLE (trigger.h) the main
+* loop sends the notes the trigger edges latched instead.
+*
+* The bytes go into a lock-free single-producer/single-consumer queue,
+* like the sample ring in sampler.c: the main loop is the only writer of
+* queueHead and the TX interrupt the only writer of queueTail. The main loop
+* never waits for the 31250 baud line. It enables the UART "FIFO not full"
+* interrupt after queueing, and the ISR copies bytes into the 4-byte TX FIFO
+* until the queue is empty and then masks the interrupt again. A note
+* change is at most six bytes, so it is on the wire within 2 ms, less than
+* one ADC conversion period. If the queue cannot take the whole change it
+* is dropped and the old note is kept, so the next change turns it off.
+*
+*******************************************************************************/
+
+#include "midi.h"
+
+#if(MIDI_ENABLE == 1u)
+
+    static volatile uint8 queue[MIDI_QUEUE_SIZE];
+    static volatile uint8 queueHead = 0u;
+    static volatile uint8 queueTail = 0u;
+
+    /* Note sounding on each channel */
+    static uint8 sounding[SAMPLER_CHANNELS];
+
+    /* Last status byte queued, for running status */
+    static uint8 runningStatus = MIDI_STATUS_NONE;
+
+    static uint32 drops = 0u;
+
+    static uint8 Midi_Put(uint8 head, uint8 value);
+    static uint8 Midi_PutMessage(uint8 head, uint8 status, uint8 note, uint8 velocity);
+
+#endif /* MIDI_ENABLE == 1u */
+
+
+/*******************************************************************************
+* Function Name: Midi_Start
+********************************************************************************
+*
+* Summary:
+*  Starts the MIDI UART and hooks its TX interrupt, with no note sounding.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void Midi_Start(void)
+{
+#if(MIDI_ENABLE == 1u)
+    uint8 channel;
+
+    for(channel = 0u; channel < SAMPLER_CHANNELS; channel++)
+    {
+        sounding[channel] = MIDI_NOTE_NONE;
+    }
+    queueHead = 0u;
+    queueTail = 0u;
+    runningStatus = MIDI_STATUS_NONE;
+
+    UART_MIDI_Start();
+    UART_MIDI_SetTxInterruptMode(0u); /* unmasked while there is something to send */
+    isr_MIDI_TX_StartEx(Midi_TxIsr);
+#endif /* MIDI_ENABLE == 1u */
+}
+
+
+/*******************************************************************************
+* Function Name: Midi_SendNote
+********************************************************************************
+*
+* Summary:
+*  Queues the messages that move a channel to a new note. Nothing is sent
+*  if the note is already sounding. Returns at once.
+*
+* Parameters:
+*  channel:  sampler channel
+*  note:     NotePerfect step number, 0 .. NUMBER_NOTE_PERFECT_STEPS
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void Midi_SendNote(uint8 channel, uint32 note)
+{
+#if(MIDI_ENABLE == 1u)
+    uint8 midiNote = (uint8)(note + MIDI_NOTE_OFFSET);
+    uint8 head = queueHead;
+    uint8 free = (uint8)((queueTail - head - 1u) & MIDI_QUEUE_MASK);
+
+    if(midiNote == sounding[channel])
+    {
+        return;
+    }
+
+    /* Room for both messages, with their status bytes */
+    if(free < (2u * MIDI_MESSAGE_BYTES))
+    {
+        drops++;
+        return;
+    }
+
+    if(MIDI_NOTE_NONE != sounding[channel])
+    {
+    #if(MIDI_RUNNING_STATUS == 1u)
+        head = Midi_PutMessage(head, MIDI_STATUS_NOTE_ON | MIDI_CHANNEL(channel), sounding[channel], 0u);
+    #else
+        head = Midi_PutMessage(head, MIDI_STATUS_NOTE_OFF | MIDI_CHANNEL(channel), sounding[channel], 0u);
+    #endif /* MIDI_RUNNING_STATUS == 1u */
+    }
+    head = Midi_PutMessage(head, MIDI_STATUS_NOTE_ON | MIDI_CHANNEL(channel), midiNote, MIDI_VELOCITY);
+    sounding[channel] = midiNote;
+
+    /* Publish the bytes, then let the ISR send them */
+    queueHead = head;
+    UART_MIDI_SetTxInterruptMode(UART_MIDI_TX_STS_FIFO_NOT_FULL);
+
+#else
+    (void) channel;
+    (void) note;
+#endif /* MIDI_ENABLE == 1u */
+}
+
+
+/*******************************************************************************
+* Function Name: Midi_GetDrops
+********************************************************************************
+*
+* Summary:
+*  Returns the number of note changes dropped because the queue was full.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  Dropped note changes since Midi_Start().
+*
+*******************************************************************************/
+uint32 Midi_GetDrops(void)
+{
+#if(MIDI_ENABLE == 1u)
+    return drops;
+#else
+    return 0u;
+#endif /* MIDI_ENABLE == 1u */
+}
+
+
+#if(MIDI_ENABLE == 1u)
+
+    /*******************************************************************************
+    * Function Name: Midi_Put
+    ********************************************************************************
+    *
+    * Summary:
+    *  Stores one byte at a queue position that is not yet published.
+    *
+    * Parameters:
+    *  head:   queue position
+    *  value:  byte to store
+    *
+    * Return:
+    *  Next queue position.
+    *
+    *******************************************************************************/
+    static uint8 Midi_Put(uint8 head, uint8 value)
+    {
+        queue[head] = value;
+
+        return (head + 1u) & MIDI_QUEUE_MASK;
+    }
+
+
+    /*******************************************************************************
+    * Function Name: Midi_PutMessage
+    ********************************************************************************
+    *
+    * Summary:
+    *  Stores a three byte channel message; with MIDI_RUNNING_STATUS the
+    *  status byte is left out if it is the same as the last one.
+    *
+    * Parameters:
+    *  head:      queue position
+    *  status:    status byte, with the channel
+    *  note:      note number
+    *  velocity:  velocity
+    *
+    * Return:
+    *  Next queue position.
+    *
+    *******************************************************************************/
+    static uint8 Midi_PutMessage(uint8 head, uint8 status, uint8 note, uint8 velocity)
+    {
+    #if(MIDI_RUNNING_STATUS == 1u)
+        if(status != runningStatus)
+    #endif /* MIDI_RUNNING_STATUS == 1u */
+        {
+            head = Midi_Put(head, status);
+            runningStatus = status;
+        }
+        head = Midi_Put(head, note);
+
+        return Midi_Put(head, velocity);
+    }
+
+
+    /*******************************************************************************
+    * Function Name: Midi_TxIsr
+    ********************************************************************************
+    *
+    * Summary:
+    *  UART_MIDI TX handler. Fills the TX FIFO from the queue; once the queue
+    *  is empty the FIFO-not-full interrupt is masked until the next note.
+    *
+    *******************************************************************************/
+    CY_ISR(Midi_TxIsr)
+    {
+        uint8 tail = queueTail;
+
+        while((tail != queueHead) && (0u != (UART_MIDI_ReadTxStatus() & UART_MIDI_TX_STS_FIFO_NOT_FULL)))
+        {
+            UART_MIDI_WriteTxData(queue[tail]);
+            tail = (tail + 1u) & MIDI_QUEUE_MASK;
+        }
+        queueTail = tail;
+
+        if(tail == queueHead)
+        {
+            UART_MIDI_SetTxInterruptMode(0u);
+        }
+    }
+
+#endif /* MIDI_ENABLE == 1u */
+
+/* [] END OF FILE */
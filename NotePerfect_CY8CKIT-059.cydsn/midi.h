@@ -0,0 +1,74 @@
+/******************************************************************************
+* File Name: midi.h
+*
+* Version 1.0
+*
+* Description:
+* This file contains the constants and function prototypes of the MIDI note
+* output.
+*
+*******************************************************************************/
+
+#if !defined(MIDI_H)
+#define MIDI_H
+
+#include <device.h>
+#include "sampler.h"
+#include "notetable.h"
+
+/* Set to 1u to send the quantized notes as MIDI. Requires a UART component
+* named UART_MIDI (31250 baud, 8N1, TX only, TX interrupt source "FIFO not
+* full") with an Interrupt component named isr_MIDI_TX on its tx_interrupt
+* terminal, and a MIDI OUT circuit on the tx pin.
+*/
+#define MIDI_ENABLE                 (0u)
+
+/* 1 = running status: the status byte is left out when it repeats, and
+* Note Off is sent as Note On with velocity 0 so it repeats more often.
+*/
+#define MIDI_RUNNING_STATUS         (1u)
+
+/* MIDI channel (0 = channel 1) of each sampler channel */
+#define MIDI_CHANNEL(channel)       ((uint8)(channel))
+
+/* MIDI note of step 0 (0 V), 24 = C1 */
+#define MIDI_NOTE_OFFSET            (24u)
+#define MIDI_VELOCITY               (100u)
+
+/* Depth of the TX queue (must be a power of two) */
+#define MIDI_QUEUE_SIZE             (32u)
+#define MIDI_QUEUE_MASK             (MIDI_QUEUE_SIZE - 1u)
+
+/* Channel voice messages */
+#define MIDI_STATUS_NOTE_OFF        (0x80u)
+#define MIDI_STATUS_NOTE_ON         (0x90u)
+#define MIDI_MESSAGE_BYTES          (3u)
+
+/* No status sent yet, and no note sounding */
+#define MIDI_STATUS_NONE            (0x00u)
+#define MIDI_NOTE_NONE              (0xFFu)
+
+#if((MIDI_ENABLE == 1u) && (NUMBER_NOTES_PER_VOLT != 12u))
+    #error "MIDI notes need NUMBER_NOTES_PER_VOLT = 12"
+#endif /* (MIDI_ENABLE == 1u) && (NUMBER_NOTES_PER_VOLT != 12u) */
+
+#if((MIDI_NOTE_OFFSET + NUMBER_NOTE_PERFECT_STEPS) > 127u)
+    #error "The highest step is above MIDI note 127, lower MIDI_NOTE_OFFSET"
+#endif /* (MIDI_NOTE_OFFSET + NUMBER_NOTE_PERFECT_STEPS) > 127u */
+
+
+/***************************************
+*        Function Prototypes
+***************************************/
+
+void Midi_Start(void);
+void Midi_SendNote(uint8 channel, uint32 note);
+uint32 Midi_GetDrops(void);
+
+#if(MIDI_ENABLE == 1u)
+    CY_ISR_PROTO(Midi_TxIsr);
+#endif /* MIDI_ENABLE == 1u */
+
+#endif /* MIDI_H */
+
+/* [] END OF FILE */
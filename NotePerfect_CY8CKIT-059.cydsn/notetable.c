@@ -0,0 +1,28 @@
+/******************************************************************************
+* File Name: notetable.c
+*
+* Version 1.0
+*
+* Description:
+* This file contains the NotePerfect step number lookup tables. The entries
+* are expanded by the preprocessor from NOTE_PWM_COUNTS() and
+* NOTE_PWM_FINE(), so the tables are computed at compile time from the
+* tuning constants in notetable.h and are placed in flash.
+*
+*******************************************************************************/
+
+#include "notetable.h"
+
+/* NotePerfect step number lookup table */
+uint16 const CYCODE PWM_Lookup[NOTE_TABLE_SIZE] =
+{
+    NOTE_ROW_64(NOTE_PWM_COUNTS, 0u), NOTE_ROW_64(NOTE_PWM_COUNTS, 64u)
+};
+
+/* Fractional step number lookup table */
+uint32 const CYCODE PWM_FineLookup[NOTE_TABLE_SIZE] =
+{
+    NOTE_ROW_64(NOTE_PWM_FINE, 0u), NOTE_ROW_64(NOTE_PWM_FINE, 64u)
+};
+
+/* [] END OF FILE */
\ No newline at end of file
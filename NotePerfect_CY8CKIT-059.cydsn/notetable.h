@@ -0,0 +1,92 @@
+/******************************************************************************
+* File Name: notetable.h
+*
+* Version 1.0
+*
+* Description:
+* This file contains the tuning constants of the NotePerfect quantizer and
+* the compile-time generated PWM lookup table. Changing the number of notes
+* per volt (e.g. 12-TET, 19-TET, 24-TET) or the control voltage range only
+* requires editing the #defines below; the table follows automatically.
+*
+*******************************************************************************/
+
+#if !defined(NOTETABLE_H)
+#define NOTETABLE_H
+
+#include "hal.h"
+
+/* Number of "NotePerfect" control voltages per volt */
+#define NUMBER_NOTES_PER_VOLT       (12u)
+
+/* Maximum control voltage */
+#define MAX_CONTROL_VOLTAGE         (5u)
+
+/* Total number of "NotePerfect" quantized steps/values (60) */
+#define NUMBER_NOTE_PERFECT_STEPS (NUMBER_NOTES_PER_VOLT * MAX_CONTROL_VOLTAGE)
+
+/* Full-scale control voltage (in mV) */
+#define FULL_SCALE_MV               (MAX_CONTROL_VOLTAGE * 1000u)
+
+/* NotePerfect step size (in mV) */
+#define NOTEPERFECT_STEP_SIZE_MV    ((MAX_CONTROL_VOLTAGE * 1000) / NUMBER_NOTE_PERFECT_STEPS)
+
+/* Correction window (in mV) */
+#define CORRECTION_WINDOW           (NOTEPERFECT_STEP_SIZE_MV / 4)
+
+/* Hysteresis past each step boundary before the output moves (in mV, 0 = off) */
+#define HYSTERESIS_WINDOW           (NOTEPERFECT_STEP_SIZE_MV / 8)
+
+/* RC-filtered PWM output: one compare count per mV */
+#define PWM_COUNTS_PER_VOLT         (1000u)
+
+/* Number of PWM_Lookup entries, steps 0 to NUMBER_NOTE_PERFECT_STEPS must fit */
+#define NOTE_TABLE_SIZE             (128u)
+
+#if(NUMBER_NOTE_PERFECT_STEPS >= NOTE_TABLE_SIZE)
+    #error "NUMBER_NOTE_PERFECT_STEPS does not fit in PWM_Lookup, increase NOTE_TABLE_SIZE"
+#endif /* NUMBER_NOTE_PERFECT_STEPS >= NOTE_TABLE_SIZE */
+
+/* PWM compare value of step n, rounded to the nearest count. Entries past
+* the last step hold the full-scale value so an out of range index is safe.
+*/
+#define NOTE_PWM_COUNTS(n)          ((uint16)(((n) < NUMBER_NOTE_PERFECT_STEPS) ? \
+                                    ((((n) * MAX_CONTROL_VOLTAGE * PWM_COUNTS_PER_VOLT * 2u) / \
+                                      NUMBER_NOTE_PERFECT_STEPS + 1u) / 2u) : \
+                                    (MAX_CONTROL_VOLTAGE * PWM_COUNTS_PER_VOLT)))
+
+/* Fractional bits of the fine lookup table (1/256 PWM count) */
+#define NOTE_FINE_BITS              (8u)
+#define NOTE_FINE_MASK              ((1u << NOTE_FINE_BITS) - 1u)
+
+/* PWM compare value of step n scaled by 2^NOTE_FINE_BITS, rounded */
+#define NOTE_PWM_FINE(n)            ((uint32)(((n) < NUMBER_NOTE_PERFECT_STEPS) ? \
+                                    ((((n) * MAX_CONTROL_VOLTAGE * PWM_COUNTS_PER_VOLT * 2u << NOTE_FINE_BITS) / \
+                                      NUMBER_NOTE_PERFECT_STEPS + 1u) / 2u) : \
+                                    ((MAX_CONTROL_VOLTAGE * PWM_COUNTS_PER_VOLT) << NOTE_FINE_BITS)))
+
+/* Expand an entry macro for 8 and 64 consecutive steps, for the tables of
+* NOTE_TABLE_SIZE entries computed at compile time
+*/
+#define NOTE_ROW_8(f, n)    f((n) + 0u), f((n) + 1u), f((n) + 2u), f((n) + 3u), \
+                            f((n) + 4u), f((n) + 5u), f((n) + 6u), f((n) + 7u)
+
+#define NOTE_ROW_64(f, n)   NOTE_ROW_8(f, (n) + 0u),  NOTE_ROW_8(f, (n) + 8u),  \
+                            NOTE_ROW_8(f, (n) + 16u), NOTE_ROW_8(f, (n) + 24u), \
+                            NOTE_ROW_8(f, (n) + 32u), NOTE_ROW_8(f, (n) + 40u), \
+                            NOTE_ROW_8(f, (n) + 48u), NOTE_ROW_8(f, (n) + 56u)
+
+
+/***************************************
+*           Global Variables
+***************************************/
+
+/* NotePerfect step number lookup table */
+extern uint16 const CYCODE PWM_Lookup[NOTE_TABLE_SIZE];
+
+/* Same table with NOTE_FINE_BITS of fraction, for the dithered output */
+extern uint32 const CYCODE PWM_FineLookup[NOTE_TABLE_SIZE];
+
+#endif /* NOTETABLE_H */
+
+/* [] END OF FILE */
@@ -0,0 +1,637 @@
+/******************************************************************************
+* File Name: output.c
+*
+* Version 1.0
+*
+* Description:
+* This file contains the quantized CV outputs. Each output is an
+* RC-filtered PWM, buffered by an opamp.
+*
+* In the default single channel mode the front panel output (PWM) carries
+* the channel selected with the CapSense buttons. In SAMPLER_ROUND_ROBIN mode
+* IN_A drives PWM and IN_B drives a second output, PWM_B. PWM_B is not part
+* of the stock schematic: it has to be added with the same period as PWM
+* and routed to its own RC filter and buffer.
+*
+* Notes are converted through a table of compare values with NOTE_FINE_BITS
+* of fraction: PWM_FineLookup by default, or a calibrated table installed
+* with Output_SetTable().
+*
+* With OUTPUT_LATCH_AT_TC set, Output_Write() only posts the new compare
+* value to a one-entry mailbox per output and the PWM terminal count
+* interrupt copies it into the PWM. The output then always changes on a
+* period boundary, one period at most after the quantizer decided, no
+* matter how long the rest of the main loop pass takes, and a half-written
+* period (a runt or doubled pulse) can no longer reach the RC filter. A
+* value posted before the previous one was latched replaces it.
+*
+* Each mailbox has a value written only by the main loop (or the glide, see
+* below) and a flag set by the writer and cleared by the ISR. The flag is set after the value is
+* stored, and 16-bit stores are atomic, so no critical section is needed.
+*
+* With OUTPUT_DITHER set the terminal count interrupt instead runs a
+* first-order sigma-delta modulator on the fraction: the fraction is added
+* to a residue every period and the compare value is one count higher in
+* the periods where the residue carries. The average duty cycle, and so
+* the filtered voltage, then resolves 1/256 of the 1 mV PWM step, with a
+* one count ripple that the RC filter removes. The target is a single
+* 32-bit word per output, so it too is updated without a critical section.
+*
+* Output_WriteNote() is the output-processing stage: it first transposes
+* the note by a whole number of steps and octaves, then either outputs it
+* at once or, with OUTPUT_GLIDE, hands it to a glide. The glide moves a
+* fixed-point position towards the target from the SysTick ISR, so its time
+* does not depend on the main loop. The quantizer already picks the new
+* note at once; only the output slews. OUTPUT_GLIDE_LINEAR adds a constant
+* increment per tick, a constant slew rate like an analog slew limiter.
+* OUTPUT_GLIDE_EXPONENTIAL moves a fixed fraction of the remaining distance
+* per tick, the RC curve of a classic portamento. The target is a single
+* 32-bit word written by Output_WriteNote(), and the position is owned by
+* the ISR. The first note after power-up is output at once, as are notes
+* written with Output_WriteStep() (calibration).
+*
+*******************************************************************************/
+
+#include "output.h"
+
+#if(OUTPUT_TC_ISR == 1u)
+
+    /* Output driven by PWM_B in round-robin mode */
+    #define OUTPUT_CHANNEL_B        (SAMPLER_CHANNEL(IN_B))
+
+    /* Output driven by PWM */
+    #if(SAMPLER_ROUND_ROBIN == 1u)
+        #define OUTPUT_CHANNEL_MAIN (SAMPLER_CHANNEL(IN_A))
+    #else
+        #define OUTPUT_CHANNEL_MAIN (0u)
+    #endif /* SAMPLER_ROUND_ROBIN == 1u */
+
+    static uint8 Output_NextCompare(uint8 channel, uint16 * compare);
+
+#endif /* OUTPUT_TC_ISR == 1u */
+
+#if(OUTPUT_DITHER == 1u)
+
+    /* Compare value with NOTE_FINE_BITS of fraction, per output */
+    static volatile uint32 targetFine[OUTPUT_CHANNELS];
+
+    /* Sigma-delta residue, owned by the ISR */
+    static uint32 residue[OUTPUT_CHANNELS];
+
+#elif(OUTPUT_LATCH_AT_TC == 1u)
+
+    /* Compare value waiting for the next terminal count, per output */
+    static volatile uint16 mailboxCompare[OUTPUT_CHANNELS];
+    static volatile uint8 mailboxFull[OUTPUT_CHANNELS];
+
+#endif /* OUTPUT_DITHER == 1u */
+
+/* Fractional compare value of each note */
+static uint32 const * noteTable = PWM_FineLookup;
+
+/* Transpose applied by Output_WriteNote(), in steps */
+static volatile int32 transpose = (OUTPUT_TRANSPOSE_OCTAVES * (int32) NUMBER_NOTES_PER_VOLT) + OUTPUT_TRANSPOSE_STEPS;
+
+/* Note last written with Output_WriteNote(), before the transpose, and 1 =
+* written at least once; output again when the transpose changes.
+*/
+static volatile uint8 currentNote[OUTPUT_CHANNELS];
+static volatile uint8 currentValid[OUTPUT_CHANNELS];
+
+#if(OUTPUT_DITHER == 0u)
+    /* Compare value last written, per output, for Output_GetCompare() */
+    static volatile uint16 writtenCompare[OUTPUT_CHANNELS];
+#endif /* OUTPUT_DITHER == 0u */
+
+#if(OUTPUT_GLIDE != OUTPUT_GLIDE_OFF)
+
+    /* Glide target and position, compare values scaled by
+    * 2^(NOTE_FINE_BITS + OUTPUT_GLIDE_FRAC_BITS). The target is written by
+    * Output_WriteNote(), the position by the tick ISR.
+    */
+    static volatile uint32 glideTarget[OUTPUT_CHANNELS];
+    static volatile uint32 glidePosition[OUTPUT_CHANNELS];
+
+    /* Set once a channel has been written; the first note is not glided to */
+    static uint8 glideValid[OUTPUT_CHANNELS];
+
+    /* Linear: position change per tick. Exponential: fraction of the
+    * remaining distance per tick, scaled by 2^OUTPUT_GLIDE_COEFF_BITS.
+    * 0 = glide off.
+    */
+    static volatile uint32 glideStep = 0u;
+
+#endif /* OUTPUT_GLIDE != OUTPUT_GLIDE_OFF */
+
+static void Output_WriteFine(uint8 channel, uint32 fine);
+
+
+/*******************************************************************************
+* Function Name: Output_Start
+********************************************************************************
+*
+* Summary:
+*  Starts the output PWMs and, with OUTPUT_LATCH_AT_TC or OUTPUT_DITHER,
+*  hooks their terminal count interrupts.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void Output_Start(void)
+{
+#if((OUTPUT_TC_ISR == 1u) || (OUTPUT_GLIDE != OUTPUT_GLIDE_OFF))
+    uint8 channel;
+
+    for(channel = 0u; channel < OUTPUT_CHANNELS; channel++)
+    {
+    #if(OUTPUT_DITHER == 1u)
+        targetFine[channel] = 0u;
+        residue[channel] = 0u;
+    #elif(OUTPUT_LATCH_AT_TC == 1u)
+        mailboxFull[channel] = 0u;
+    #endif /* OUTPUT_DITHER == 1u */
+    #if(OUTPUT_GLIDE != OUTPUT_GLIDE_OFF)
+        glideValid[channel] = 0u;
+        glideTarget[channel] = 0u;
+        glidePosition[channel] = 0u;
+    #endif /* OUTPUT_GLIDE != OUTPUT_GLIDE_OFF */
+    }
+#endif /* (OUTPUT_TC_ISR == 1u) || (OUTPUT_GLIDE != OUTPUT_GLIDE_OFF) */
+
+#if(OUTPUT_GLIDE != OUTPUT_GLIDE_OFF)
+    Output_SetGlide(OUTPUT_GLIDE_MS);
+#endif /* OUTPUT_GLIDE != OUTPUT_GLIDE_OFF */
+
+    PWM_Start();
+
+#if(SAMPLER_ROUND_ROBIN == 1u)
+    PWM_B_Start();
+#endif /* SAMPLER_ROUND_ROBIN == 1u */
+
+#if(OUTPUT_TC_ISR == 1u)
+    PWM_SetInterruptMode(PWM_STATUS_TC_INT_EN_MASK);
+    isr_PWM_StartEx(Output_PwmIsr);
+
+    #if(SAMPLER_ROUND_ROBIN == 1u)
+        PWM_B_SetInterruptMode(PWM_B_STATUS_TC_INT_EN_MASK);
+        isr_PWM_B_StartEx(Output_PwmBIsr);
+    #endif /* SAMPLER_ROUND_ROBIN == 1u */
+#endif /* OUTPUT_TC_ISR == 1u */
+}
+
+
+/*******************************************************************************
+* Function Name: Output_Write
+********************************************************************************
+*
+* Summary:
+*  Sets the output voltage of one channel, at once or (OUTPUT_LATCH_AT_TC,
+*  OUTPUT_DITHER) at the next terminal count of its PWM.
+*
+* Parameters:
+*  channel:  input channel, 0 .. OUTPUT_CHANNELS - 1
+*  compare:  PWM compare value, from PWM_Lookup[]
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void Output_Write(uint8 channel, uint16 compare)
+{
+#if(OUTPUT_DITHER == 0u)
+    writtenCompare[channel] = compare;
+#endif /* OUTPUT_DITHER == 0u */
+
+#if(OUTPUT_DITHER == 1u)
+    targetFine[channel] = (uint32) compare << NOTE_FINE_BITS;
+#elif(OUTPUT_LATCH_AT_TC == 1u)
+    mailboxCompare[channel] = compare;
+    mailboxFull[channel] = 1u; /* publish after the value is stored */
+#elif(SAMPLER_ROUND_ROBIN == 1u)
+    if(SAMPLER_CHANNEL(IN_B) == channel)
+    {
+        PWM_B_WriteCompare(compare);
+    }
+    else
+    {
+        PWM_WriteCompare(compare);
+    }
+#else
+    (void) channel;
+    PWM_WriteCompare(compare);
+#endif /* OUTPUT_DITHER == 1u */
+}
+
+
+/*******************************************************************************
+* Function Name: Output_WriteNote
+********************************************************************************
+*
+* Summary:
+*  Sets the output of one channel to a note: transposes it and outputs it
+*  at once, or with OUTPUT_GLIDE makes it the target of the glide.
+*
+* Parameters:
+*  channel:  input channel, 0 .. OUTPUT_CHANNELS - 1
+*  note:     NotePerfect step number, 0 .. NUMBER_NOTE_PERFECT_STEPS
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void Output_WriteNote(uint8 channel, uint32 note)
+{
+    uint32 step = Output_Transpose(note);
+
+    currentNote[channel] = (uint8) note;
+    currentValid[channel] = 1u;
+
+#if(OUTPUT_GLIDE != OUTPUT_GLIDE_OFF)
+    if((0u != glideStep) && (0u != glideValid[channel]))
+    {
+        /* the tick ISR moves the output there */
+        glideTarget[channel] = noteTable[step] << OUTPUT_GLIDE_FRAC_BITS;
+        return;
+    }
+#endif /* OUTPUT_GLIDE != OUTPUT_GLIDE_OFF */
+
+    Output_WriteStep(channel, step);
+}
+
+
+/*******************************************************************************
+* Function Name: Output_WriteStep
+********************************************************************************
+*
+* Summary:
+*  Sets the output of one channel to a note table entry at once, with no
+*  transpose and no glide; a glide in progress is stopped there. With
+*  OUTPUT_DITHER the fraction of the table entry is kept, otherwise it is
+*  rounded to the nearest compare count.
+*
+* Parameters:
+*  channel:  input channel, 0 .. OUTPUT_CHANNELS - 1
+*  step:     NotePerfect step number, 0 .. NOTE_TABLE_SIZE - 1
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void Output_WriteStep(uint8 channel, uint32 step)
+{
+#if(OUTPUT_GLIDE != OUTPUT_GLIDE_OFF)
+    /* The tick ISR must not move the output between the two writes */
+    uint8 interruptState = CyEnterCriticalSection();
+
+    glidePosition[channel] = noteTable[step] << OUTPUT_GLIDE_FRAC_BITS;
+    glideTarget[channel] = glidePosition[channel];
+    glideValid[channel] = 1u;
+    Output_WriteFine(channel, noteTable[step]);
+
+    CyExitCriticalSection(interruptState);
+#else
+    Output_WriteFine(channel, noteTable[step]);
+#endif /* OUTPUT_GLIDE != OUTPUT_GLIDE_OFF */
+}
+
+
+/*******************************************************************************
+* Function Name: Output_SetTable
+********************************************************************************
+*
+* Summary:
+*  Installs the note table used by Output_WriteNote(), e.g. one corrected
+*  with measured output calibration. Takes effect at the next note written.
+*
+* Parameters:
+*  table:  NOTE_TABLE_SIZE compare values scaled by 2^NOTE_FINE_BITS, kept
+*          by the caller; NULL restores PWM_FineLookup.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void Output_SetTable(uint32 const table[])
+{
+    noteTable = (NULL != table) ? table : PWM_FineLookup;
+}
+
+
+/*******************************************************************************
+* Function Name: Output_SetTranspose
+********************************************************************************
+*
+* Summary:
+*  Sets the transpose applied by Output_WriteNote(). When it changes, the
+*  note of every output is written again with the new transpose, so the
+*  output moves at once (gliding with OUTPUT_GLIDE) instead of at the next
+*  note.
+*
+* Parameters:
+*  octaves:  whole octaves (volts), may be negative
+*  steps:    steps on top of the octaves, may be negative
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void Output_SetTranspose(int8 octaves, int8 steps)
+{
+    int32 newTranspose = ((int32) octaves * (int32) NUMBER_NOTES_PER_VOLT) + steps;
+    uint8 interruptState;
+    uint8 channel;
+
+    if(newTranspose != transpose)
+    {
+        /* A trigger edge must not output an older note in between */
+        interruptState = CyEnterCriticalSection();
+
+        transpose = newTranspose;
+        for(channel = 0u; channel < OUTPUT_CHANNELS; channel++)
+        {
+            if(0u != currentValid[channel])
+            {
+                Output_WriteNote(channel, currentNote[channel]);
+            }
+        }
+
+        CyExitCriticalSection(interruptState);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: Output_GetCompare
+********************************************************************************
+*
+* Summary:
+*  Returns the compare value last written to an output: the transposed,
+*  calibrated and (OUTPUT_GLIDE) gliding value, for the readout. With
+*  OUTPUT_DITHER it is the mean compare value, rounded.
+*
+* Parameters:
+*  channel:  input channel, 0 .. OUTPUT_CHANNELS - 1
+*
+* Return:
+*  PWM compare value.
+*
+*******************************************************************************/
+uint16 Output_GetCompare(uint8 channel)
+{
+#if(OUTPUT_DITHER == 1u)
+    return (uint16)((targetFine[channel] + (1u << (NOTE_FINE_BITS - 1u))) >> NOTE_FINE_BITS);
+#else
+    return writtenCompare[channel];
+#endif /* OUTPUT_DITHER == 1u */
+}
+
+
+/*******************************************************************************
+* Function Name: Output_Transpose
+********************************************************************************
+*
+* Summary:
+*  Applies the transpose to a note, clamped to the output range.
+*
+* Parameters:
+*  note:  NotePerfect step number, 0 .. NUMBER_NOTE_PERFECT_STEPS
+*
+* Return:
+*  Transposed step number, 0 .. NUMBER_NOTE_PERFECT_STEPS.
+*
+*******************************************************************************/
+uint32 Output_Transpose(uint32 note)
+{
+    int32 step = (int32) note + transpose;
+
+    step = (step < 0) ? 0 : step;
+    step = (step > (int32) NUMBER_NOTE_PERFECT_STEPS) ? (int32) NUMBER_NOTE_PERFECT_STEPS : step;
+
+    return (uint32) step;
+}
+
+
+#if(OUTPUT_GLIDE != OUTPUT_GLIDE_OFF)
+
+    /*******************************************************************************
+    * Function Name: Output_SetGlide
+    ********************************************************************************
+    *
+    * Summary:
+    *  Sets the glide time: per volt for OUTPUT_GLIDE_LINEAR, the time
+    *  constant for OUTPUT_GLIDE_EXPONENTIAL. 0 turns the glide off; a glide
+    *  in progress then ends at its target on the next tick.
+    *
+    * Parameters:
+    *  ms:  glide time in ms
+    *
+    * Return:
+    *  None.
+    *
+    *******************************************************************************/
+    void Output_SetGlide(uint16 ms)
+    {
+        uint32 ticks = (uint32) ms * OUTPUT_GLIDE_TICKS_PER_MS;
+        uint32 step = 0u;
+
+        if(0u != ticks)
+        {
+        #if(OUTPUT_GLIDE == OUTPUT_GLIDE_LINEAR)
+            step = OUTPUT_GLIDE_ONE_VOLT / ticks;
+        #else
+            step = (1uL << OUTPUT_GLIDE_COEFF_BITS) / ticks;
+        #endif /* OUTPUT_GLIDE == OUTPUT_GLIDE_LINEAR */
+            step = (0u == step) ? 1u : step;
+        }
+
+        glideStep = step;
+    }
+
+
+    /*******************************************************************************
+    * Function Name: Output_GlideTick
+    ********************************************************************************
+    *
+    * Summary:
+    *  Moves the glide position of every output one tick towards its target
+    *  and writes the output when its value changes. Called from the SysTick
+    *  ISR every TICK_PERIOD_US.
+    *
+    * Parameters:
+    *  None.
+    *
+    * Return:
+    *  None.
+    *
+    *******************************************************************************/
+    void Output_GlideTick(void)
+    {
+        uint8 channel;
+        uint32 target;
+        uint32 position;
+        uint32 distance;
+        uint32 move;
+        uint32 step = glideStep;
+
+        for(channel = 0u; channel < OUTPUT_CHANNELS; channel++)
+        {
+            target = glideTarget[channel];
+            position = glidePosition[channel];
+
+            if(target != position)
+            {
+                distance = (target > position) ? (target - position) : (position - target);
+
+            #if(OUTPUT_GLIDE == OUTPUT_GLIDE_LINEAR)
+                move = step;
+            #else
+                /* Below one fine count the curve is done */
+                move = (distance < (1uL << OUTPUT_GLIDE_FRAC_BITS)) ? distance :
+                       (uint32)(((uint64) distance * step) >> OUTPUT_GLIDE_COEFF_BITS);
+                move = (0u == move) ? 1u : move;
+            #endif /* OUTPUT_GLIDE == OUTPUT_GLIDE_LINEAR */
+
+                /* The last move, or any move with the glide off, lands on the target */
+                move = ((0u == step) || (move > distance)) ? distance : move;
+                position = (target > position) ? (position + move) : (position - move);
+
+                if((position >> OUTPUT_GLIDE_FRAC_BITS) != (glidePosition[channel] >> OUTPUT_GLIDE_FRAC_BITS))
+                {
+                    Output_WriteFine(channel, position >> OUTPUT_GLIDE_FRAC_BITS);
+                }
+                glidePosition[channel] = position;
+            }
+        }
+    }
+
+#endif /* OUTPUT_GLIDE != OUTPUT_GLIDE_OFF */
+
+
+/*******************************************************************************
+* Function Name: Output_WriteFine
+********************************************************************************
+*
+* Summary:
+*  Sets the output of one channel to a compare value with NOTE_FINE_BITS of
+*  fraction. With OUTPUT_DITHER the fraction is kept, otherwise it is
+*  rounded to the nearest compare count.
+*
+* Parameters:
+*  channel:  input channel, 0 .. OUTPUT_CHANNELS - 1
+*  fine:     compare value scaled by 2^NOTE_FINE_BITS
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+static void Output_WriteFine(uint8 channel, uint32 fine)
+{
+#if(OUTPUT_DITHER == 1u)
+    targetFine[channel] = fine;
+#else
+    Output_Write(channel, (uint16)((fine + (1u << (NOTE_FINE_BITS - 1u))) >> NOTE_FINE_BITS));
+#endif /* OUTPUT_DITHER == 1u */
+}
+
+
+#if(OUTPUT_TC_ISR == 1u)
+
+    /*******************************************************************************
+    * Function Name: Output_NextCompare
+    ********************************************************************************
+    *
+    * Summary:
+    *  Returns the compare value for the PWM period that has just started.
+    *  Called from the terminal count interrupt.
+    *
+    * Parameters:
+    *  channel:  input channel, 0 .. OUTPUT_CHANNELS - 1
+    *  compare:  receives the compare value
+    *
+    * Return:
+    *  Non-zero if the compare value must be written.
+    *
+    *******************************************************************************/
+    static uint8 Output_NextCompare(uint8 channel, uint16 * compare)
+    {
+    #if(OUTPUT_DITHER == 1u)
+
+        uint32 fine = targetFine[channel];
+        uint32 sum = residue[channel] + (fine & NOTE_FINE_MASK);
+
+        /* One count more whenever the residue carries */
+        residue[channel] = sum & NOTE_FINE_MASK;
+        *compare = (uint16)((fine >> NOTE_FINE_BITS) + (sum >> NOTE_FINE_BITS));
+
+        return 1u;
+
+    #else
+
+        uint8 full = mailboxFull[channel];
+
+        if(0u != full)
+        {
+            *compare = mailboxCompare[channel];
+            mailboxFull[channel] = 0u;
+        }
+
+        return full;
+
+    #endif /* OUTPUT_DITHER == 1u */
+    }
+
+
+    /*******************************************************************************
+    * Function Name: Output_PwmIsr
+    ********************************************************************************
+    *
+    * Summary:
+    *  PWM terminal count handler. Reading the status register clears the
+    *  interrupt; the next compare value is then copied into the PWM, which
+    *  uses it from the period that has just started.
+    *
+    *******************************************************************************/
+    CY_ISR(Output_PwmIsr)
+    {
+        uint16 compare;
+
+        (void) PWM_ReadStatusRegister();
+
+        if(0u != Output_NextCompare(OUTPUT_CHANNEL_MAIN, &compare))
+        {
+            PWM_WriteCompare(compare);
+        }
+    }
+
+
+    #if(SAMPLER_ROUND_ROBIN == 1u)
+
+        /*******************************************************************************
+        * Function Name: Output_PwmBIsr
+        ********************************************************************************
+        *
+        * Summary:
+        *  PWM_B terminal count handler, see Output_PwmIsr.
+        *
+        *******************************************************************************/
+        CY_ISR(Output_PwmBIsr)
+        {
+            uint16 compare;
+
+            (void) PWM_B_ReadStatusRegister();
+
+            if(0u != Output_NextCompare(OUTPUT_CHANNEL_B, &compare))
+            {
+                PWM_B_WriteCompare(compare);
+            }
+        }
+
+    #endif /* SAMPLER_ROUND_ROBIN == 1u */
+
+#endif /* OUTPUT_TC_ISR == 1u */
+
+/* [] END OF FILE */
@@ -0,0 +1,109 @@
+/******************************************************************************
+* File Name: output.h
+*
+* Version 1.0
+*
+* Description:
+* This file contains the function prototypes for the quantized CV outputs.
+*
+*******************************************************************************/
+
+#if !defined(OUTPUT_H)
+#define OUTPUT_H
+
+#include <device.h>
+#include "sampler.h"
+#include "notetable.h"
+#include "tick.h"
+
+/* One CV output per sampled input */
+#define OUTPUT_CHANNELS             (SAMPLER_CHANNELS)
+
+/* Set to 1u to latch new compare values at the PWM terminal count instead
+* of writing them at once. Requires an Interrupt component named isr_PWM on
+* the interrupt terminal of PWM (and isr_PWM_B on PWM_B in round-robin
+* mode), with the PWM interrupt on terminal count enabled.
+*/
+#define OUTPUT_LATCH_AT_TC          (0u)
+
+/* Set to 1u to dither the PWM LSB (first-order sigma-delta at the PWM rate)
+* so the filtered output resolves 1/2^NOTE_FINE_BITS of a compare count.
+* Uses the same terminal count interrupt(s) as OUTPUT_LATCH_AT_TC, and
+* latches at terminal count as well.
+*/
+#define OUTPUT_DITHER               (0u)
+
+/* Both options are served by the PWM terminal count interrupt */
+#if((OUTPUT_LATCH_AT_TC == 1u) || (OUTPUT_DITHER == 1u))
+    #define OUTPUT_TC_ISR           (1u)
+#else
+    #define OUTPUT_TC_ISR           (0u)
+#endif /* (OUTPUT_LATCH_AT_TC == 1u) || (OUTPUT_DITHER == 1u) */
+
+/* Power-up transpose of every output, in octaves and steps; the result is
+* clamped to 0 .. NUMBER_NOTE_PERFECT_STEPS.
+*/
+#define OUTPUT_TRANSPOSE_OCTAVES    (0)
+#define OUTPUT_TRANSPOSE_STEPS      (0)
+
+/* Glide (portamento) between notes, stepped from the SysTick ISR:
+*  OUTPUT_GLIDE_OFF          new notes are output at once
+*  OUTPUT_GLIDE_LINEAR       constant slew rate, OUTPUT_GLIDE_MS per volt
+*  OUTPUT_GLIDE_EXPONENTIAL  RC-like approach, time constant OUTPUT_GLIDE_MS
+*/
+#define OUTPUT_GLIDE_OFF            (0u)
+#define OUTPUT_GLIDE_LINEAR         (1u)
+#define OUTPUT_GLIDE_EXPONENTIAL    (2u)
+
+#define OUTPUT_GLIDE                (OUTPUT_GLIDE_OFF)
+
+/* Power-up glide time (in ms), changed with Output_SetGlide() */
+#define OUTPUT_GLIDE_MS             (100u)
+
+/* Extra fraction bits of the glide position, below the NOTE_FINE_BITS of
+* the note table, so slow glides still move every tick.
+*/
+#define OUTPUT_GLIDE_FRAC_BITS      (8u)
+#define OUTPUT_GLIDE_ONE_VOLT       ((uint32) PWM_COUNTS_PER_VOLT << (NOTE_FINE_BITS + OUTPUT_GLIDE_FRAC_BITS))
+
+/* Glide update rate */
+#define OUTPUT_GLIDE_TICKS_PER_MS   (TICKS_PER_MS)
+
+/* Fraction bits of the exponential glide coefficient */
+#define OUTPUT_GLIDE_COEFF_BITS     (24u)
+
+#if((OUTPUT_GLIDE != OUTPUT_GLIDE_OFF) && ((MAX_CONTROL_VOLTAGE * PWM_COUNTS_PER_VOLT) > \
+                                           (0xFFFFFFFFu >> (NOTE_FINE_BITS + OUTPUT_GLIDE_FRAC_BITS))))
+    #error "The glide position does not fit in 32 bits, reduce OUTPUT_GLIDE_FRAC_BITS"
+#endif /* (OUTPUT_GLIDE != OUTPUT_GLIDE_OFF) && (full scale > glide range) */
+
+
+/***************************************
+*        Function Prototypes
+***************************************/
+
+void Output_Start(void);
+void Output_Write(uint8 channel, uint16 compare);
+void Output_WriteNote(uint8 channel, uint32 note);
+void Output_WriteStep(uint8 channel, uint32 step);
+void Output_SetTable(uint32 const table[]);
+void Output_SetTranspose(int8 octaves, int8 steps);
+uint32 Output_Transpose(uint32 note);
+uint16 Output_GetCompare(uint8 channel);
+
+#if(OUTPUT_GLIDE != OUTPUT_GLIDE_OFF)
+    void Output_SetGlide(uint16 ms);
+    void Output_GlideTick(void);
+#endif /* OUTPUT_GLIDE != OUTPUT_GLIDE_OFF */
+
+#if(OUTPUT_TC_ISR == 1u)
+    CY_ISR_PROTO(Output_PwmIsr);
+
+    #if(SAMPLER_ROUND_ROBIN == 1u)
+        CY_ISR_PROTO(Output_PwmBIsr);
+    #endif /* SAMPLER_ROUND_ROBIN == 1u */
+#endif /* OUTPUT_TC_ISR == 1u */
+
+#endif /* OUTPUT_H */
+
+/* [] END OF FILE */
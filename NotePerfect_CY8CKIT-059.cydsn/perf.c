@@ -0,0 +1,200 @@
+/******************************************************************************
+* File Name: perf.c
+*
+* Version 1.0
+*
+* Description:
+* This file contains the cycle-count instrumentation. Each stage of the main
+* loop is bracketed by PERF_BEGIN()/PERF_END(), which read the Cortex-M3 DWT
+* cycle counter; the difference is folded into the min/max/total of that
+* stage. Reading CYCCNT is a single load, so the probe itself costs only a
+* few cycles and works at any optimization level. The 32-bit counter wraps
+* after 2^32 cycles (about 3 minutes at 24 MHz), which an unsigned
+* subtraction handles for stages shorter than that.
+*
+*******************************************************************************/
+
+#include "perf.h"
+
+uint32 Perf_BeginCycles[PERF_STAGE_COUNT];
+
+static Perf_STATS stageStats[PERF_STAGE_COUNT];
+
+static char8 const CYCODE stageNames[PERF_STAGE_COUNT][PERF_NAME_LENGTH + 1u] =
+{
+    "Loop",
+    "Caps",
+    "LCD ",
+    "ADC ",
+    "Filt",
+    "Quan",
+    "PWM ",
+    "LED ",
+    "Tick"
+};
+
+
+/*******************************************************************************
+* Function Name: Perf_Start
+********************************************************************************
+*
+* Summary:
+*  Enables the DWT cycle counter and clears the statistics. Does nothing
+*  when PERF_ENABLE is 0u.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void Perf_Start(void)
+{
+#if(PERF_ENABLE == 1u)
+    PERF_DEMCR_REG |= PERF_DEMCR_TRCENA;
+    PERF_DWT_CYCCNT_REG = 0u;
+    PERF_DWT_CTRL_REG |= PERF_DWT_CTRL_CYCCNTENA;
+#endif /* PERF_ENABLE == 1u */
+
+    Perf_Reset();
+}
+
+
+/*******************************************************************************
+* Function Name: Perf_Reset
+********************************************************************************
+*
+* Summary:
+*  Clears the statistics of all stages.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void Perf_Reset(void)
+{
+    uint8 stage;
+    uint8 interruptState;
+
+    interruptState = CyEnterCriticalSection();
+
+    for(stage = 0u; stage < PERF_STAGE_COUNT; stage++)
+    {
+        stageStats[stage].min = 0xFFFFFFFFu;
+        stageStats[stage].max = 0u;
+        stageStats[stage].count = 0u;
+        stageStats[stage].total = 0u;
+    }
+
+    CyExitCriticalSection(interruptState);
+}
+
+
+/*******************************************************************************
+* Function Name: Perf_Record
+********************************************************************************
+*
+* Summary:
+*  Adds one measurement to a stage. Called by PERF_END().
+*
+* Parameters:
+*  stage:   PERF_STAGE_LOOP .. PERF_STAGE_COUNT - 1
+*  cycles:  duration of the stage in CPU cycles
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void Perf_Record(uint8 stage, uint32 cycles)
+{
+    Perf_STATS * stats = &stageStats[stage];
+
+    if(cycles < stats->min)
+    {
+        stats->min = cycles;
+    }
+
+    if(cycles > stats->max)
+    {
+        stats->max = cycles;
+    }
+
+    stats->count++;
+    stats->total += cycles;
+}
+
+
+/*******************************************************************************
+* Function Name: Perf_GetStats
+********************************************************************************
+*
+* Summary:
+*  Returns a consistent copy of the statistics of one stage.
+*
+* Parameters:
+*  stage:  PERF_STAGE_LOOP .. PERF_STAGE_COUNT - 1
+*  stats:  receives min, max, count and total cycles
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void Perf_GetStats(uint8 stage, Perf_STATS * stats)
+{
+    uint8 interruptState;
+
+    /* PERF_STAGE_TICK is updated from the SysTick ISR */
+    interruptState = CyEnterCriticalSection();
+    *stats = stageStats[stage];
+    CyExitCriticalSection(interruptState);
+}
+
+
+/*******************************************************************************
+* Function Name: Perf_GetMean
+********************************************************************************
+*
+* Summary:
+*  Returns the mean duration of one stage.
+*
+* Parameters:
+*  stage:  PERF_STAGE_LOOP .. PERF_STAGE_COUNT - 1
+*
+* Return:
+*  Mean cycles, 0 if the stage has not run yet.
+*
+*******************************************************************************/
+uint32 Perf_GetMean(uint8 stage)
+{
+    Perf_STATS stats;
+
+    Perf_GetStats(stage, &stats);
+
+    return (0u == stats.count) ? 0u : (uint32)(stats.total / stats.count);
+}
+
+
+/*******************************************************************************
+* Function Name: Perf_GetName
+********************************************************************************
+*
+* Summary:
+*  Returns the PERF_NAME_LENGTH character display name of a stage.
+*
+* Parameters:
+*  stage:  PERF_STAGE_LOOP .. PERF_STAGE_COUNT - 1
+*
+* Return:
+*  Zero terminated name.
+*
+*******************************************************************************/
+char8 const * Perf_GetName(uint8 stage)
+{
+    return stageNames[(stage < PERF_STAGE_COUNT) ? stage : PERF_STAGE_LOOP];
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,96 @@
+/******************************************************************************
+* File Name: perf.h
+*
+* Version 1.0
+*
+* Description:
+* This file contains the constants, macros and function prototypes for the
+* cycle-count instrumentation of the main loop.
+*
+*******************************************************************************/
+
+#if !defined(PERF_H)
+#define PERF_H
+
+#include <device.h>
+
+/* Set to 1u to time the main loop stages. The timing page of the LCD then
+* shows min/mean/max of one stage, rotating every PERF_PAGE_SECONDS, instead
+* of the overrun and drop counts. With 0u the PERF_BEGIN/PERF_END macros
+* compile to nothing.
+*/
+#define PERF_ENABLE                 (0u)
+#define PERF_PAGE_SECONDS           (2u)
+
+/* Timed stages */
+#define PERF_STAGE_LOOP             (0u)    /* one pass of the main loop, one task */
+#define PERF_STAGE_CAPSENSE         (1u)    /* button handling and scan start */
+#define PERF_STAGE_LCD              (2u)    /* display task, frame buffer writes */
+#define PERF_STAGE_ADC_WAIT         (3u)    /* draining the sample ring */
+#define PERF_STAGE_FILTER           (4u)
+#define PERF_STAGE_QUANTIZE         (5u)    /* quantizer, scale and hysteresis */
+#define PERF_STAGE_PWM              (6u)    /* output compare update */
+#define PERF_STAGE_LED              (7u)    /* front panel LED housekeeping */
+#define PERF_STAGE_TICK             (8u)    /* SysTick ISR, LCD flush nibbles */
+#define PERF_STAGE_COUNT            (9u)
+
+/* Length of the stage names returned by Perf_GetName() */
+#define PERF_NAME_LENGTH            (4u)
+
+/* Cortex-M3 debug registers: DEMCR.TRCENA powers the DWT, CTRL.CYCCNTENA
+* starts the 32-bit CPU cycle counter.
+*/
+#define PERF_DEMCR_REG              (*(reg32 *) 0xE000EDFCu)
+#define PERF_DEMCR_TRCENA           (0x01000000u)
+#define PERF_DWT_CTRL_REG           (*(reg32 *) 0xE0001000u)
+#define PERF_DWT_CTRL_CYCCNTENA     (0x00000001u)
+#define PERF_DWT_CYCCNT_REG         (*(reg32 *) 0xE0001004u)
+
+/* Statistics of one stage, in CPU cycles */
+typedef struct
+{
+    uint32 min;
+    uint32 max;
+    uint32 count;
+    uint64 total;
+} Perf_STATS;
+
+
+/***************************************
+*        Function Prototypes
+***************************************/
+
+void Perf_Start(void);
+void Perf_Reset(void);
+void Perf_Record(uint8 stage, uint32 cycles);
+void Perf_GetStats(uint8 stage, Perf_STATS * stats);
+uint32 Perf_GetMean(uint8 stage);
+char8 const * Perf_GetName(uint8 stage);
+
+
+/***************************************
+*        Global Variables
+***************************************/
+
+/* Cycle count at PERF_BEGIN() of each stage */
+extern uint32 Perf_BeginCycles[PERF_STAGE_COUNT];
+
+
+/***************************************
+*        Macros
+***************************************/
+
+/* The begin/end pair of a stage must not be nested inside the same stage.
+* Interrupts that hit between them are included in the stage time.
+*/
+#if(PERF_ENABLE == 1u)
+    #define PERF_BEGIN(stage)       (Perf_BeginCycles[(stage)] = PERF_DWT_CYCCNT_REG)
+    #define PERF_END(stage)         Perf_Record((stage), PERF_DWT_CYCCNT_REG - Perf_BeginCycles[(stage)])
+#else
+    #define PERF_BEGIN(stage)       ((void) 0)
+    #define PERF_END(stage)         ((void) 0)
+#endif /* PERF_ENABLE == 1u */
+
+#endif /* PERF_H */
+
+/* [] END OF FILE */
@@ -0,0 +1,336 @@
+/******************************************************************************
+* File Name: profile.c
+*
+* Version 1.0
+*
+* Description:
+* This file contains the run-time ADC profiles. The 20-bit configuration
+* gives sub-mV readings but a low conversion rate and a long filter, so a
+* new note takes a while to come through. A profile trades resolution for
+* rate: it selects one of the ADC component's configurations and sets the
+* matching filter time constant, jump threshold and quantizer scaling.
+*
+*  - PROFILE_PRECISE: configuration 1, 20-bit, as designed; for tuning.
+*  - PROFILE_FAST:    configuration 2, 16-bit, shorter filter.
+*  - PROFILE_ULTRA:   configuration 3, 12-bit, shortest filter; for live
+*                     patches where latency matters more than precision.
+*
+* Configurations 2 and 3 are added in the ADC component (TopDesign) with
+* the input range, buffer and reference of configuration 1 and only the
+* resolution and conversion rate changed, e.g. 16-bit at 8000 and 12-bit at
+* 32000 conversions per second; the resolutions must match Profile_Table.
+* ADC_SelectConfiguration() loads the component's ADC_CountsPerVolt and
+* ADC_Offset for the configuration. Profile_SetAdcConfig() is the one place
+* that switches configurations, for the profiles and for idle mode (idle.h):
+* it keeps the sampler, the quantizer scaling and the filters in step.
+*
+* SIGNAL_SLOPE is in 20-bit counts and is scaled down by the resolution, so
+* the jump threshold stays the same voltage. The calibration record is
+* measured on configuration 1 and only its input scaling is tied to it:
+* the other profiles use the component scaling of their configuration, and
+* the corrected output table of all of them.
+*
+* A long press of Misc steps to the next profile. With PROFILE_SAVE the
+* choice is written to one EEPROM byte and restored at power-up.
+*
+*******************************************************************************/
+
+#include "profile.h"
+#include "filter.h"
+#include "quantizer.h"
+#include "calib.h"
+#include "stddef.h"
+
+/* Settings of each profile */
+static Profile_CONFIG const CYCODE Profile_Table[PROFILE_COUNT] =
+{
+    { 1u, 20u, FILTER_IIR_SHIFT, ' ' },     /* PROFILE_PRECISE */
+    { 2u, 16u, 4u,               'F' },     /* PROFILE_FAST */
+    { 3u, 12u, 2u,               'U' },     /* PROFILE_ULTRA */
+};
+
+/* Profile in use */
+static uint8 selected = PROFILE_PRECISE;
+
+#if(PROFILE_ENABLE == 1u)
+    static void Profile_Apply(void);
+#endif /* PROFILE_ENABLE == 1u */
+
+
+/*******************************************************************************
+* Function Name: Profile_Start
+********************************************************************************
+*
+* Summary:
+*  Selects the saved profile, or PROFILE_DEFAULT. Must be called after
+*  Calib_Load(), Sampler_Start() and ADC_StartConvert(); the caller seeds
+*  the filters afterwards as usual.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void Profile_Start(void)
+{
+#if(PROFILE_ENABLE == 1u)
+#if(PROFILE_SAVE == 1u)
+    uint8 saved;
+
+    EEPROM_Start();
+
+    /* EEPROM is mapped in the address space */
+    saved = CY_GET_REG8(CYDEV_EE_BASE + (PROFILE_EEPROM_ROW * CYDEV_EEPROM_ROW_SIZE) + PROFILE_EEPROM_BYTE);
+    selected = (saved < PROFILE_COUNT) ? saved : PROFILE_DEFAULT;
+#else
+    selected = PROFILE_DEFAULT;
+#endif /* PROFILE_SAVE == 1u */
+
+    /* Configuration 1 and its scaling are already in place */
+    if(PROFILE_PRECISE != selected)
+    {
+        Profile_Apply();
+    }
+#endif /* PROFILE_ENABLE == 1u */
+}
+
+
+/*******************************************************************************
+* Function Name: Profile_Select
+********************************************************************************
+*
+* Summary:
+*  Switches the ADC to a profile, drops the conversions of the previous
+*  configuration and reseeds the filter of every channel with a fresh one.
+*  Blocks for a few conversions. The hysteresis of every channel is
+*  released, so the caller outputs the notes of the next pass again.
+*
+* Parameters:
+*  profile:  PROFILE_PRECISE, PROFILE_FAST or PROFILE_ULTRA
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void Profile_Select(uint8 profile)
+{
+#if(PROFILE_ENABLE == 1u)
+    selected = (profile < PROFILE_COUNT) ? profile : PROFILE_DEFAULT;
+    Profile_Apply();
+#else
+    (void) profile;
+#endif /* PROFILE_ENABLE == 1u */
+}
+
+
+/*******************************************************************************
+* Function Name: Profile_SetAdcConfig
+********************************************************************************
+*
+* Summary:
+*  Switches the ADC to a component configuration through
+*  Sampler_SelectConfiguration(), installs the quantizer scaling of that
+*  configuration (the calibration record for configuration 1) and reseeds
+*  the filter of every channel with a conversion taken after the decimator
+*  settled. Blocks for a few conversions. Used by the profiles and by idle
+*  mode, the filter time constant and jump threshold are not changed.
+*
+* Parameters:
+*  adcConfig:  ADC component configuration, 1 .. 4
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void Profile_SetAdcConfig(uint8 adcConfig)
+{
+#if(SAMPLER_USE_DMA == 0u)
+    int32 samples[SAMPLER_BATCH_SIZE];
+    uint8 i;
+#endif /* SAMPLER_USE_DMA == 0u */
+    uint8 channel;
+
+    Sampler_SelectConfiguration(adcConfig);
+
+    /* The calibrated input scaling only applies to configuration 1 */
+    if(Profile_Table[PROFILE_PRECISE].adcConfig == adcConfig)
+    {
+        (void) Calib_Load();
+    }
+    else
+    {
+        Quantizer_Init(ADC_CountsPerVolt, ADC_Offset);
+    }
+
+    for(channel = 0u; channel < SAMPLER_CHANNELS; channel++)
+    {
+    #if(SAMPLER_USE_DMA == 1u)
+        while(NULL != Sampler_GetBlock())
+        {
+            Sampler_ReleaseBlock();
+        }
+
+        /* One whole block covers the decimator settling */
+        (void) Sampler_WaitSample(channel);
+    #else
+        while(0u != Sampler_Read(channel, samples, SAMPLER_BATCH_SIZE))
+        {
+        }
+
+        for(i = 0u; i < PROFILE_SETTLE_SAMPLES; i++)
+        {
+            (void) Sampler_WaitSample(channel);
+        }
+    #endif /* SAMPLER_USE_DMA == 1u */
+
+        Filter_Init(channel, Sampler_WaitSample(channel));
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: Profile_Next
+********************************************************************************
+*
+* Summary:
+*  Selects the next profile, see Profile_Select(). With PROFILE_SAVE it is
+*  also written to EEPROM, which blocks for one EEPROM row write.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  New profile.
+*
+*******************************************************************************/
+uint8 Profile_Next(void)
+{
+#if(PROFILE_ENABLE == 1u)
+    Profile_Select((uint8)((selected + 1u) % PROFILE_COUNT));
+
+#if(PROFILE_SAVE == 1u)
+    if(CYRET_SUCCESS == EEPROM_UpdateTemperature())
+    {
+        (void) EEPROM_ByteWrite(selected, (uint8) PROFILE_EEPROM_ROW, PROFILE_EEPROM_BYTE);
+    }
+#endif /* PROFILE_SAVE == 1u */
+#endif /* PROFILE_ENABLE == 1u */
+
+    return selected;
+}
+
+
+/*******************************************************************************
+* Function Name: Profile_GetSelected
+********************************************************************************
+*
+* Summary:
+*  Returns the profile in use.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  PROFILE_PRECISE, PROFILE_FAST or PROFILE_ULTRA.
+*
+*******************************************************************************/
+uint8 Profile_GetSelected(void)
+{
+    return selected;
+}
+
+
+/*******************************************************************************
+* Function Name: Profile_GetAdcConfig
+********************************************************************************
+*
+* Summary:
+*  Returns the ADC configuration of the profile in use, e.g. to return to it
+*  after idle mode.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  ADC component configuration, 1..4.
+*
+*******************************************************************************/
+uint8 Profile_GetAdcConfig(void)
+{
+    return Profile_Table[selected].adcConfig;
+}
+
+
+/*******************************************************************************
+* Function Name: Profile_GetResolution
+********************************************************************************
+*
+* Summary:
+*  Returns the ADC resolution of the profile in use.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  Resolution in bits.
+*
+*******************************************************************************/
+uint8 Profile_GetResolution(void)
+{
+    return Profile_Table[selected].resolution;
+}
+
+
+/*******************************************************************************
+* Function Name: Profile_GetTag
+********************************************************************************
+*
+* Summary:
+*  Returns the one character LCD tag of a profile.
+*
+* Parameters:
+*  profile:  PROFILE_PRECISE, PROFILE_FAST or PROFILE_ULTRA
+*
+* Return:
+*  Tag, blank for PROFILE_PRECISE.
+*
+*******************************************************************************/
+char8 Profile_GetTag(uint8 profile)
+{
+    return (profile < PROFILE_COUNT) ? Profile_Table[profile].tag : ' ';
+}
+
+
+#if(PROFILE_ENABLE == 1u)
+
+    /*******************************************************************************
+    * Function Name: Profile_Apply
+    ********************************************************************************
+    *
+    * Summary:
+    *  Installs the filter time constant and jump threshold of the selected
+    *  profile, then loads its ADC configuration, see Profile_SetAdcConfig().
+    *
+    * Parameters:
+    *  None.
+    *
+    * Return:
+    *  None.
+    *
+    *******************************************************************************/
+    static void Profile_Apply(void)
+    {
+        Profile_CONFIG const * config = &Profile_Table[selected];
+        uint8 shift = PROFILE_REFERENCE_BITS - config->resolution;
+
+        /* Same jump threshold in volts, rounded */
+        Filter_SetProfile((SIGNAL_SLOPE + ((1 << shift) >> 1)) >> shift, config->filterShift);
+
+        Profile_SetAdcConfig(config->adcConfig);
+    }
+
+#endif /* PROFILE_ENABLE == 1u */
+
+/* [] END OF FILE */
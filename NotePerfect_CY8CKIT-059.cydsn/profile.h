@@ -0,0 +1,80 @@
+/******************************************************************************
+* File Name: profile.h
+*
+* Version 1.0
+*
+* Description:
+* This file contains the constants, profile record and function prototypes
+* of the run-time ADC resolution/rate profiles.
+*
+*******************************************************************************/
+
+#if !defined(PROFILE_H)
+#define PROFILE_H
+
+#include <device.h>
+#include "sampler.h"
+
+/* 1 = ADC profiles selectable at run time with a long press of Misc. Needs
+* configurations 2 and 3 of the ADC component in TopDesign (see profile.c);
+* with 0 the ADC stays on configuration 1 as before.
+*/
+#define PROFILE_ENABLE              (0u)
+
+/* 1 = keep the selected profile in EEPROM across power cycles. Uses the
+* EEPROM component of the calibration (calib.h).
+*/
+#define PROFILE_SAVE                (0u)
+
+/* Profiles */
+#define PROFILE_PRECISE             (0u)    /* 20-bit, ADC configuration 1 */
+#define PROFILE_FAST                (1u)    /* 16-bit, ADC configuration 2 */
+#define PROFILE_ULTRA               (2u)    /* 12-bit, ADC configuration 3 */
+#define PROFILE_COUNT               (3u)
+
+/* Profile at power-up when none is saved */
+#define PROFILE_DEFAULT             (PROFILE_PRECISE)
+
+/* Resolution SIGNAL_SLOPE and the calibration record refer to */
+#define PROFILE_REFERENCE_BITS      (20u)
+
+/* Conversions dropped after a switch while the decimator settles */
+#define PROFILE_SETTLE_SAMPLES      (4u)
+
+/* Saved profile: first byte of the last EEPROM row, clear of the
+* calibration record. A blank EEPROM reads as PROFILE_PRECISE.
+*/
+#define PROFILE_EEPROM_ROW          ((CYDEV_EE_SIZE / CYDEV_EEPROM_ROW_SIZE) - 1u)
+#define PROFILE_EEPROM_BYTE         (0u)
+
+
+/***************************************
+*        Data Struct Definition
+***************************************/
+
+/* One ADC profile */
+typedef struct
+{
+    uint8 adcConfig;                /* ADC component configuration, 1..4 */
+    uint8 resolution;               /* bits, as set for that configuration */
+    uint8 filterShift;              /* IIR time constant of 2^filterShift samples */
+    char8 tag;                      /* shown on the LCD, blank for PROFILE_PRECISE */
+} Profile_CONFIG;
+
+
+/***************************************
+*        Function Prototypes
+***************************************/
+
+void Profile_Start(void);
+void Profile_Select(uint8 profile);
+void Profile_SetAdcConfig(uint8 adcConfig);
+uint8 Profile_Next(void);
+uint8 Profile_GetSelected(void);
+uint8 Profile_GetAdcConfig(void);
+uint8 Profile_GetResolution(void);
+char8 Profile_GetTag(uint8 profile);
+
+#endif /* PROFILE_H */
+
+/* [] END OF FILE */
@@ -0,0 +1,168 @@
+/******************************************************************************
+* File Name: quantizer.c
+*
+* Version 1.0
+*
+* Description:
+* This file contains the NotePerfect quantizer. Filtered ADC counts are
+* mapped straight to the nearest step number with one 32x32->64 bit
+* multiply by a precomputed reciprocal:
+*
+*   step = ((counts - offset) * (steps * 2^32 / (countsPerVolt * maxVolts))
+*           + 2^31) >> 32
+*
+* The shift by 32 is free (the high word of UMULL), so there is no division
+* and no intermediate conversion to mV, and the rounding decision uses the
+* full ADC resolution. The low word is the distance from the chosen step.
+*
+* Quantizer_Hold() is a Schmitt-style stage on the final output note: the
+* previous note is kept until the input is closer to the new one by more
+* than twice HYSTERESIS_WINDOW, i.e. until it is HYSTERESIS_WINDOW past the
+* boundary between them. An input parked on a boundary therefore no longer
+* makes the output trill between two notes.
+*
+*******************************************************************************/
+
+#include "quantizer.h"
+
+/* Steps per ADC count, scaled by 2^32 */
+static uint32 stepsPerCount = 0u;
+
+/* ADC counts at 0 V */
+static int32 zeroCounts = 0;
+
+/* Output note of the hysteresis stage, per input channel */
+static uint32 heldStep[QUANTIZER_CHANNELS];
+
+
+/*******************************************************************************
+* Function Name: Quantizer_Init
+********************************************************************************
+*
+* Summary:
+*  Computes the reciprocal from the ADC scaling. Must be called again
+*  whenever the ADC gain or offset change. Also releases the hysteresis of
+*  every channel.
+*
+* Parameters:
+*  countsPerVolt:  ADC counts per volt (ADC_CountsPerVolt on the target)
+*  offset:         ADC counts at 0 V (ADC_Offset on the target)
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void Quantizer_Init(int32 countsPerVolt, int32 offset)
+{
+    uint8 channel;
+    uint64 countsFullScale = (uint64) countsPerVolt * MAX_CONTROL_VOLTAGE;
+
+    /* The only division, done once; rounded to the nearest */
+    stepsPerCount = (uint32)((((uint64) NUMBER_NOTE_PERFECT_STEPS << QUANTIZER_FRAC_SHIFT) +
+                              (countsFullScale / 2u)) / countsFullScale);
+    zeroCounts = offset;
+
+    for(channel = 0u; channel < QUANTIZER_CHANNELS; channel++)
+    {
+        heldStep[channel] = 0u;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: Quantizer_Quantize
+********************************************************************************
+*
+* Summary:
+*  Returns the step nearest to the filtered ADC counts, clamped to
+*  0..NUMBER_NOTE_PERFECT_STEPS.
+*
+* Parameters:
+*  counts:  filtered ADC counts
+*  error:   receives how far the input is from the step, as a fraction of
+*           one step scaled by 2^32 (positive when the input is above).
+*           At the range limits the error saturates at +/- half a step.
+*
+* Return:
+*  NotePerfect step number.
+*
+*******************************************************************************/
+uint32 Quantizer_Quantize(int32 counts, int32 * error)
+{
+    int32 input = counts - zeroCounts;
+    uint64 product;
+    uint32 step;
+
+    if(input < 0)
+    {
+        /* Below step 0, the error is negative */
+        step = 0u;
+        product = (uint64)(0u - (uint32) input) * stepsPerCount;
+        *error = (product >= QUANTIZER_HALF_STEP) ? (int32) QUANTIZER_HALF_STEP : -(int32) product;
+    }
+    else
+    {
+        product = ((uint64)(uint32) input * stepsPerCount) + QUANTIZER_HALF_STEP;
+        step = (uint32)(product >> QUANTIZER_FRAC_SHIFT);
+
+        if(step > NUMBER_NOTE_PERFECT_STEPS)
+        {
+            step = NUMBER_NOTE_PERFECT_STEPS;
+            *error = (int32)(QUANTIZER_HALF_STEP - 1u);
+        }
+        else
+        {
+            *error = (int32)((uint32) product - QUANTIZER_HALF_STEP);
+        }
+    }
+
+    return step;
+}
+
+
+/*******************************************************************************
+* Function Name: Quantizer_Hold
+********************************************************************************
+*
+* Summary:
+*  Applies hysteresis to the output note. The candidate is accepted only if
+*  the input is clearly nearer to it than to the note currently held.
+*
+* Parameters:
+*  channel:    input channel, 0 .. QUANTIZER_CHANNELS - 1
+*  candidate:  note the output should move to (nearest step, or the nearest
+*              note of the selected scale)
+*  step:       nearest step, from Quantizer_Quantize()
+*  error:      quantizer error of that step
+*
+* Return:
+*  NotePerfect step number to output.
+*
+*******************************************************************************/
+uint32 Quantizer_Hold(uint8 channel, uint32 candidate, uint32 step, int32 error)
+{
+    int64 position;
+    int64 heldDistance;
+    int64 candidateDistance;
+
+    if(candidate != heldStep[channel])
+    {
+        /* Input position in steps, scaled by 2^32 */
+        position = ((int64) step << QUANTIZER_FRAC_SHIFT) + error;
+
+        heldDistance = position - ((int64) heldStep[channel] << QUANTIZER_FRAC_SHIFT);
+        heldDistance = (heldDistance < 0) ? -heldDistance : heldDistance;
+
+        candidateDistance = position - ((int64) candidate << QUANTIZER_FRAC_SHIFT);
+        candidateDistance = (candidateDistance < 0) ? -candidateDistance : candidateDistance;
+
+        if((heldDistance - candidateDistance) > (2 * QUANTIZER_HYSTERESIS))
+        {
+            heldStep[channel] = candidate;
+        }
+    }
+
+    return heldStep[channel];
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,47 @@
+/******************************************************************************
+* File Name: quantizer.h
+*
+* Version 1.0
+*
+* Description:
+* This file contains the constants and function prototypes for the
+* division-free NotePerfect quantizer and its hysteresis stage.
+*
+*******************************************************************************/
+
+#if !defined(QUANTIZER_H)
+#define QUANTIZER_H
+
+#include "hal.h"
+#include "notetable.h"
+
+/* One hysteresis state per sampled input */
+#define QUANTIZER_CHANNELS          (HAL_CHANNELS)
+
+/* Quantizer errors are signed fractions of one step scaled by 2^32, so
+* +/- half a step spans the full int32 range.
+*/
+#define QUANTIZER_FRAC_SHIFT        (32u)
+#define QUANTIZER_HALF_STEP         (0x80000000u)
+
+/* CORRECTION_WINDOW (in mV) expressed as a step fraction */
+#define QUANTIZER_CORRECTION_WINDOW ((int32)((((uint64) CORRECTION_WINDOW * NUMBER_NOTE_PERFECT_STEPS) \
+                                     << QUANTIZER_FRAC_SHIFT) / FULL_SCALE_MV))
+
+
+/* HYSTERESIS_WINDOW (in mV) expressed as a step fraction */
+#define QUANTIZER_HYSTERESIS        ((int64)((((uint64) HYSTERESIS_WINDOW * NUMBER_NOTE_PERFECT_STEPS) \
+                                     << QUANTIZER_FRAC_SHIFT) / FULL_SCALE_MV))
+
+
+/***************************************
+*        Function Prototypes
+***************************************/
+
+void Quantizer_Init(int32 countsPerVolt, int32 offset);
+uint32 Quantizer_Quantize(int32 counts, int32 * error);
+uint32 Quantizer_Hold(uint8 channel, uint32 candidate, uint32 step, int32 error);
+
+#endif /* QUANTIZER_H */
+
+/* [] END OF FILE */
@@ -0,0 +1,517 @@
+/******************************************************************************
+* File Name: sampler.c
+*
+* Version 1.0
+*
+* Description:
+* This file contains the ADC sampling stage. Two capture modes are provided,
+* selected by SAMPLER_USE_DMA in sampler.h:
+*
+* 1. Interrupt mode (default): the DelSig ADC end-of-conversion interrupt
+*    (ADC_IRQ) reads every conversion result and pushes it into a lock-free
+*    single-producer/single-consumer ring. The main loop drains the ring in
+*    batches, so a slow pass (LCD, CapSense) no longer delays or drops ADC
+*    conversions. The ISR is the only writer of ringHead and the main loop is
+*    the only writer of ringTail. Both indexes are 8-bit, so every access is
+*    atomic on the Cortex-M3 and no critical section is needed.
+*
+*    With SAMPLER_ROUND_ROBIN set the ISR also drives the analog mux,
+*    alternating between IN_A and IN_B, and there is one ring per channel.
+*    The conversions made while the decimator still holds the previous
+*    input are dropped in the ISR.
+*
+* 2. DMA mode: DMA_ADC moves the decimator output into two ping-pong RAM
+*    blocks of SAMPLER_BLOCK_SIZE conversions. The CPU is interrupted once
+*    per block (isr_DMA_ADC) instead of once per conversion, and the main
+*    loop filters a whole block while DMA fills the other one.
+*
+*******************************************************************************/
+
+#include "sampler.h"
+
+/* Number of conversions (or blocks, in DMA mode) dropped because the main
+* loop fell behind.
+*/
+static volatile uint32 overruns = 0u;
+
+#if(SAMPLER_USE_DMA == 1u)
+
+    /* DMA_ADC channel configuration */
+    #define SAMPLER_DMA_REQUEST_PER_BURST   (1u)
+    #define SAMPLER_DMA_SRC_BASE            (CYDEV_PERIPH_BASE)
+    #define SAMPLER_DMA_DST_BASE            (CYDEV_SRAM_BASE)
+
+    /* Number of bits above the 24-bit decimator output */
+    #define SAMPLER_SIGN_SHIFT              (8u)
+
+    static int32 block[2u][SAMPLER_BLOCK_SIZE];
+    static uint8 dmaChannel;
+    static uint8 dmaTd[2u];
+
+    /* Block DMA is currently writing, toggled at every block completion */
+    static volatile uint8 fillBlock = 0u;
+
+    /* Set by the ISR when a block is complete, cleared by the main loop */
+    static volatile uint8 blockReady = 0u;
+    static volatile uint8 readyBlock = 0u;
+
+#else
+
+    static volatile int32 ring[SAMPLER_CHANNELS][SAMPLER_RING_SIZE];
+    static volatile uint8 ringHead[SAMPLER_CHANNELS];
+    static volatile uint8 ringTail[SAMPLER_CHANNELS];
+
+    #if(SAMPLER_ROUND_ROBIN == 1u)
+        /* Mux input being converted, owned by the ISR */
+        static uint8 muxInput = IN_A;
+
+        /* Conversions left to drop, then to keep, before the next switch */
+        static uint8 settleCount = SAMPLER_SETTLE_SAMPLES;
+        static uint8 dwellCount = 0u;
+    #endif /* SAMPLER_ROUND_ROBIN == 1u */
+
+#endif /* SAMPLER_USE_DMA == 1u */
+
+
+/*******************************************************************************
+* Function Name: Sampler_Start
+********************************************************************************
+*
+* Summary:
+*  Resets the capture state and takes over the ADC results. In interrupt mode
+*  Sampler_AdcIsr is hooked onto the ADC_IRQ vector; in DMA mode ADC_IRQ is
+*  disabled and the ping-pong DMA transfer is started. Must be called after
+*  ADC_Start(), which installs the component's own handler, and in
+*  round-robin mode after myMux_Start().
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void Sampler_Start(void)
+{
+#if(SAMPLER_USE_DMA == 0u)
+    uint8 channel;
+#endif /* SAMPLER_USE_DMA == 0u */
+
+    overruns = 0u;
+
+#if(SAMPLER_USE_DMA == 1u)
+
+    fillBlock = 0u;
+    blockReady = 0u;
+
+    /* Conversions are read by DMA only */
+    ADC_IRQ_Disable();
+
+    dmaChannel = DMA_ADC_DmaInitialize(SAMPLER_BYTES_PER_SAMPLE, SAMPLER_DMA_REQUEST_PER_BURST,
+                                       HI16(SAMPLER_DMA_SRC_BASE), HI16(SAMPLER_DMA_DST_BASE));
+    dmaTd[0u] = CyDmaTdAllocate();
+    dmaTd[1u] = CyDmaTdAllocate();
+
+    /* Each TD fills one block, raises nrq and chains to the other block */
+    CyDmaTdSetConfiguration(dmaTd[0u], SAMPLER_BLOCK_BYTES, dmaTd[1u],
+                            CY_DMA_TD_INC_DST_ADR | DMA_ADC__TD_TERMOUT_EN);
+    CyDmaTdSetConfiguration(dmaTd[1u], SAMPLER_BLOCK_BYTES, dmaTd[0u],
+                            CY_DMA_TD_INC_DST_ADR | DMA_ADC__TD_TERMOUT_EN);
+    CyDmaTdSetAddress(dmaTd[0u], LO16((uint32) ADC_DEC_SAMP_PTR), LO16((uint32) block[0u]));
+    CyDmaTdSetAddress(dmaTd[1u], LO16((uint32) ADC_DEC_SAMP_PTR), LO16((uint32) block[1u]));
+    CyDmaChSetInitialTd(dmaChannel, dmaTd[0u]);
+
+    isr_DMA_ADC_StartEx(Sampler_DmaIsr);
+    (void) CyDmaChEnable(dmaChannel, 1u);
+
+#else
+
+    for(channel = 0u; channel < SAMPLER_CHANNELS; channel++)
+    {
+        ringHead[channel] = 0u;
+        ringTail[channel] = 0u;
+    }
+
+    #if(SAMPLER_ROUND_ROBIN == 1u)
+        muxInput = IN_A;
+        settleCount = SAMPLER_SETTLE_SAMPLES;
+        dwellCount = 0u;
+        myMux_FastSelect(muxInput);
+    #endif /* SAMPLER_ROUND_ROBIN == 1u */
+
+    ADC_IRQ_StartEx(Sampler_AdcIsr);
+
+#endif /* SAMPLER_USE_DMA == 1u */
+}
+
+
+/*******************************************************************************
+* Function Name: Sampler_GetOverruns
+********************************************************************************
+*
+* Summary:
+*  Returns the number of conversions (interrupt mode) or blocks (DMA mode)
+*  lost because the main loop fell behind.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  Overrun count since Sampler_Start().
+*
+*******************************************************************************/
+uint32 Sampler_GetOverruns(void)
+{
+    return overruns;
+}
+
+
+/*******************************************************************************
+* Function Name: Sampler_IsPending
+********************************************************************************
+*
+* Summary:
+*  Reports whether any channel has conversions (or, in DMA mode, a complete
+*  block) the main loop has not read yet. Used to decide whether the CPU may
+*  sleep until the next conversion.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  Non-zero if there is something to read.
+*
+*******************************************************************************/
+uint8 Sampler_IsPending(void)
+{
+#if(SAMPLER_USE_DMA == 1u)
+    return blockReady;
+#else
+    uint8 channel;
+    uint8 pending = 0u;
+
+    for(channel = 0u; channel < SAMPLER_CHANNELS; channel++)
+    {
+        if(ringHead[channel] != ringTail[channel])
+        {
+            pending = 1u;
+        }
+    }
+
+    return pending;
+#endif /* SAMPLER_USE_DMA == 1u */
+}
+
+
+/*******************************************************************************
+* Function Name: Sampler_WaitSample
+********************************************************************************
+*
+* Summary:
+*  Blocks until a conversion is available and returns it. Used once at start
+*  up to seed the filter; in DMA mode the newest sample of the first block is
+*  returned and the block is released.
+*
+* Parameters:
+*  channel:  SAMPLER_CHANNEL() of the input (ignored in DMA mode)
+*
+* Return:
+*  ADC counts.
+*
+*******************************************************************************/
+int32 Sampler_WaitSample(uint8 channel)
+{
+    int32 sample;
+
+#if(SAMPLER_USE_DMA == 1u)
+
+    int32 const * samples;
+
+    (void) channel;
+
+    do
+    {
+        samples = Sampler_GetBlock();
+    }
+    while(NULL == samples);
+
+    sample = samples[SAMPLER_BLOCK_SIZE - 1u];
+    Sampler_ReleaseBlock();
+
+#else
+
+    while(0u == Sampler_Read(channel, &sample, 1u))
+    {
+        /* wait for the first conversion */
+    }
+
+#endif /* SAMPLER_USE_DMA == 1u */
+
+    return sample;
+}
+
+
+/*******************************************************************************
+* Function Name: Sampler_SelectConfiguration
+********************************************************************************
+*
+* Summary:
+*  Switches the ADC to another component configuration without losing the
+*  sampler. ADC_SelectConfiguration() installs the component's own handler
+*  for the configuration, so capture is stopped first and taken over again
+*  afterwards: the rings are emptied and Sampler_AdcIsr is hooked again, or
+*  in DMA mode ADC_IRQ is disabled again and DMA restarts on the first
+*  block. The first conversions still come from the settling decimator,
+*  and the caller reseeds the filters and the quantizer scaling.
+*
+* Parameters:
+*  config:  ADC component configuration, 1 .. 4
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void Sampler_SelectConfiguration(uint8 config)
+{
+#if(SAMPLER_USE_DMA == 1u)
+
+    (void) CyDmaChDisable(dmaChannel);
+
+    /* Stops the ADC, loads the configuration, ADC_CountsPerVolt and
+     * ADC_Offset, and starts converting again */
+    ADC_SelectConfiguration(config, 1u);
+
+    /* Conversions are read by DMA only */
+    ADC_IRQ_Disable();
+
+    fillBlock = 0u;
+    blockReady = 0u;
+    CyDmaChSetInitialTd(dmaChannel, dmaTd[0u]);
+    (void) CyDmaChEnable(dmaChannel, 1u);
+
+#else
+
+    uint8 channel;
+
+    ADC_IRQ_Disable();
+
+    /* Stops the ADC, loads the configuration, ADC_CountsPerVolt and
+     * ADC_Offset, and starts converting again */
+    ADC_SelectConfiguration(config, 1u);
+
+    for(channel = 0u; channel < SAMPLER_CHANNELS; channel++)
+    {
+        ringHead[channel] = 0u;
+        ringTail[channel] = 0u;
+    }
+
+    #if(SAMPLER_ROUND_ROBIN == 1u)
+        muxInput = IN_A;
+        settleCount = SAMPLER_SETTLE_SAMPLES;
+        dwellCount = 0u;
+        myMux_FastSelect(muxInput);
+    #endif /* SAMPLER_ROUND_ROBIN == 1u */
+
+    ADC_IRQ_StartEx(Sampler_AdcIsr);
+
+#endif /* SAMPLER_USE_DMA == 1u */
+}
+
+
+#if(SAMPLER_USE_DMA == 1u)
+
+    /*******************************************************************************
+    * Function Name: Sampler_GetBlock
+    ********************************************************************************
+    *
+    * Summary:
+    *  Returns the most recently completed DMA block, sign extended in place.
+    *  The block stays valid until Sampler_ReleaseBlock() is called or until
+    *  DMA wraps back onto it, one block period later.
+    *
+    * Parameters:
+    *  None.
+    *
+    * Return:
+    *  Pointer to SAMPLER_BLOCK_SIZE ADC counts, or NULL if no block is ready.
+    *
+    *******************************************************************************/
+    int32 const * Sampler_GetBlock(void)
+    {
+        int32 * samples = NULL;
+        uint8 i;
+
+        if(0u != blockReady)
+        {
+            samples = block[readyBlock];
+
+            /* Only the low 24 bits of the decimator output are significant */
+            for(i = 0u; i < SAMPLER_BLOCK_SIZE; i++)
+            {
+                samples[i] = (int32)((uint32) samples[i] << SAMPLER_SIGN_SHIFT) >> SAMPLER_SIGN_SHIFT;
+            }
+        }
+
+        return samples;
+    }
+
+
+    /*******************************************************************************
+    * Function Name: Sampler_ReleaseBlock
+    ********************************************************************************
+    *
+    * Summary:
+    *  Marks the block returned by Sampler_GetBlock() as consumed.
+    *
+    * Parameters:
+    *  None.
+    *
+    * Return:
+    *  None.
+    *
+    *******************************************************************************/
+    void Sampler_ReleaseBlock(void)
+    {
+        blockReady = 0u;
+    }
+
+
+    /*******************************************************************************
+    * Function Name: Sampler_DmaIsr
+    ********************************************************************************
+    *
+    * Summary:
+    *  DMA_ADC block-complete handler. Publishes the block DMA just finished;
+    *  if the previous block was never released it has been overwritten and
+    *  an overrun is counted.
+    *
+    *******************************************************************************/
+    CY_ISR(Sampler_DmaIsr)
+    {
+        if(0u != blockReady)
+        {
+            overruns++;
+        }
+
+        readyBlock = fillBlock;
+        fillBlock ^= 1u;
+        blockReady = 1u;
+    }
+
+#else
+
+    /*******************************************************************************
+    * Function Name: Sampler_Read
+    ********************************************************************************
+    *
+    * Summary:
+    *  Copies up to maxSamples of the oldest pending conversions of one channel
+    *  out of its ring.
+    *
+    * Parameters:
+    *  channel:     SAMPLER_CHANNEL() of the input
+    *  samples:     destination array for the ADC counts
+    *  maxSamples:  capacity of the destination array
+    *
+    * Return:
+    *  Number of samples copied (0 if no conversion is pending).
+    *
+    *******************************************************************************/
+    uint8 Sampler_Read(uint8 channel, int32 samples[], uint8 maxSamples)
+    {
+        uint8 tail = ringTail[channel];
+        uint8 count = 0u;
+
+        while((count < maxSamples) && (tail != ringHead[channel]))
+        {
+            samples[count] = ring[channel][tail];
+            tail = (tail + 1u) & SAMPLER_RING_MASK;
+            count++;
+        }
+
+        /* Release the slots only after the samples have been copied out */
+        ringTail[channel] = tail;
+
+        return count;
+    }
+
+
+    /*******************************************************************************
+    * Function Name: Sampler_GetCount
+    ********************************************************************************
+    *
+    * Summary:
+    *  Returns the number of conversions waiting in the ring of one channel.
+    *
+    * Parameters:
+    *  channel:  SAMPLER_CHANNEL() of the input
+    *
+    * Return:
+    *  Number of pending samples.
+    *
+    *******************************************************************************/
+    uint8 Sampler_GetCount(uint8 channel)
+    {
+        return (ringHead[channel] - ringTail[channel]) & SAMPLER_RING_MASK;
+    }
+
+
+    /*******************************************************************************
+    * Function Name: Sampler_AdcIsr
+    ********************************************************************************
+    *
+    * Summary:
+    *  ADC end-of-conversion handler. Reading the result clears the decimator
+    *  interrupt; the sample is then published to the ring. When the ring is full
+    *  the newest sample is dropped so the consumer never sees a torn slot.
+    *  In round-robin mode settling conversions are dropped here and the mux
+    *  is switched after every SAMPLER_DWELL_SAMPLES kept conversions.
+    *
+    *******************************************************************************/
+    CY_ISR(Sampler_AdcIsr)
+    {
+        int32 result = ADC_GetResult32();
+        uint8 head;
+        uint8 next;
+
+    #if(SAMPLER_ROUND_ROBIN == 1u)
+        /* The result belongs to the input selected before any switch below */
+        uint8 channel = SAMPLER_CHANNEL(muxInput);
+    #else
+        uint8 channel = 0u;
+    #endif /* SAMPLER_ROUND_ROBIN == 1u */
+
+    #if(SAMPLER_ROUND_ROBIN == 1u)
+        if(0u != settleCount)
+        {
+            settleCount--;
+            return; /* decimator still holds the other input */
+        }
+
+        if(SAMPLER_DWELL_SAMPLES == ++dwellCount)
+        {
+            /* Next input; the conversion already running is a settling one */
+            dwellCount = 0u;
+            settleCount = SAMPLER_SETTLE_SAMPLES;
+            muxInput ^= 1u;
+            myMux_FastSelect(muxInput);
+        }
+    #endif /* SAMPLER_ROUND_ROBIN == 1u */
+
+        head = ringHead[channel];
+        next = (head + 1u) & SAMPLER_RING_MASK;
+
+        if(next != ringTail[channel])
+        {
+            ring[channel][head] = result;
+            ringHead[channel] = next; /* publish after the slot is written */
+        }
+        else
+        {
+            overruns++;
+        }
+    }
+
+#endif /* SAMPLER_USE_DMA == 1u */
+
+/* [] END OF FILE */
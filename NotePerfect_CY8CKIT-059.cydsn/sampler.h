@@ -0,0 +1,94 @@
+/******************************************************************************
+* File Name: sampler.h
+*
+* Version 1.0
+*
+* Description:
+* This file contains the constants and function prototypes for the
+* interrupt-driven (or DMA-driven) ADC sampling stage of the NotePerfect
+* quantizer.
+*
+*******************************************************************************/
+
+#if !defined(SAMPLER_H)
+#define SAMPLER_H
+
+#include <device.h>
+
+/* Set to 1u to move conversions into RAM with DMA instead of ADC_IRQ.
+* Requires a DMA component named DMA_ADC (drq driven by the ADC eoc terminal)
+* and an Interrupt component named isr_DMA_ADC on the DMA nrq terminal.
+*/
+#define SAMPLER_USE_DMA             (0u)
+
+/* Set to 1u to convert both jacks: the ADC ISR alternates the analog mux
+* between IN_A and IN_B and keeps a separate sample ring per channel. After
+* every switch SAMPLER_SETTLE_SAMPLES conversions are dropped while the
+* decimator flushes the previous input, then SAMPLER_DWELL_SAMPLES are kept.
+* Each channel therefore gets SAMPLER_DWELL_SAMPLES fresh samples every
+* 2 * (SAMPLER_SETTLE_SAMPLES + SAMPLER_DWELL_SAMPLES) conversions, which
+* bounds its latency. Interrupt mode only. The second quantized CV needs a
+* PWM component named PWM_B (see output.c).
+*/
+#define SAMPLER_ROUND_ROBIN         (0u)
+#define SAMPLER_SETTLE_SAMPLES      (4u)
+#define SAMPLER_DWELL_SAMPLES       (4u)
+
+/* Analog mux inputs */
+#define IN_B                        (0u)
+#define IN_A                        (1u)
+
+#if(SAMPLER_ROUND_ROBIN == 1u)
+    /* One channel per mux input, the channel number is the mux input */
+    #define SAMPLER_CHANNELS        (2u)
+    #define SAMPLER_CHANNEL(input)  (input)
+#else
+    /* The front panel buttons switch the mux, all samples are channel 0 */
+    #define SAMPLER_CHANNELS        (1u)
+    #define SAMPLER_CHANNEL(input)  (0u)
+#endif /* SAMPLER_ROUND_ROBIN == 1u */
+
+#if((SAMPLER_ROUND_ROBIN == 1u) && (SAMPLER_USE_DMA == 1u))
+    #error "SAMPLER_ROUND_ROBIN needs the ADC interrupt, clear SAMPLER_USE_DMA"
+#endif /* (SAMPLER_ROUND_ROBIN == 1u) && (SAMPLER_USE_DMA == 1u) */
+
+/* Depth of the ADC sample ring (must be a power of two) */
+#define SAMPLER_RING_SIZE           (32u)
+#define SAMPLER_RING_MASK           (SAMPLER_RING_SIZE - 1u)
+
+/* Maximum number of samples drained by the main loop per pass */
+#define SAMPLER_BATCH_SIZE          (8u)
+
+/* Number of conversions in each DMA ping-pong block */
+#define SAMPLER_BLOCK_SIZE          (8u)
+
+/* DMA transfers the 4 decimator output bytes per conversion */
+#define SAMPLER_BYTES_PER_SAMPLE    (4u)
+#define SAMPLER_BLOCK_BYTES         (SAMPLER_BLOCK_SIZE * SAMPLER_BYTES_PER_SAMPLE)
+
+
+/***************************************
+*        Function Prototypes
+***************************************/
+
+void Sampler_Start(void);
+uint32 Sampler_GetOverruns(void);
+uint8 Sampler_IsPending(void);
+int32 Sampler_WaitSample(uint8 channel);
+void Sampler_SelectConfiguration(uint8 config);
+
+#if(SAMPLER_USE_DMA == 1u)
+    int32 const * Sampler_GetBlock(void);
+    void Sampler_ReleaseBlock(void);
+
+    CY_ISR_PROTO(Sampler_DmaIsr);
+#else
+    uint8 Sampler_Read(uint8 channel, int32 samples[], uint8 maxSamples);
+    uint8 Sampler_GetCount(uint8 channel);
+
+    CY_ISR_PROTO(Sampler_AdcIsr);
+#endif /* SAMPLER_USE_DMA == 1u */
+
+#endif /* SAMPLER_H */
+
+/* [] END OF FILE */
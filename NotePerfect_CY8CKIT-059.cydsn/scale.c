@@ -0,0 +1,311 @@
+/******************************************************************************
+* File Name: scale.c
+*
+* Version 1.0
+*
+* Description:
+* This file contains the NotePerfect scale engine. The quantizer always
+* finds the nearest chromatic step; the scale engine then moves it to the
+* nearest step allowed by the selected scale.
+*
+* The snap is a single read of a table that is rebuilt whenever the scale
+* changes. The table has two entries per chromatic step, one for inputs
+* just below the step and one for inputs just above it. All midpoints
+* between two allowed steps fall on a step or half way between two steps,
+* so this resolution gives the exact nearest allowed step. A sparse scale
+* therefore costs no more per sample than a chromatic one.
+*
+*******************************************************************************/
+
+#include "scale.h"
+
+/* Two entries (below, above) per step */
+#define SCALE_SNAP_TABLE_SIZE       (2u * (NUMBER_NOTE_PERFECT_STEPS + 1u))
+
+/* Nearest allowed step for each half step of input */
+static uint8 snapTable[SCALE_SNAP_TABLE_SIZE];
+
+static uint8 selectedScale = SCALE_CHROMATIC;
+static uint32 customMask = SCALE_MASK_CUSTOM_DEFAULT & SCALE_MASK_ALL;
+
+static char8 const CYCODE scaleNames[SCALE_COUNT][SCALE_NAME_LENGTH + 1u] =
+{
+    "Chr",
+#if(NUMBER_NOTES_PER_VOLT == 12u)
+    "Maj",
+    "Min",
+    "PMj",
+    "PMn",
+#endif /* NUMBER_NOTES_PER_VOLT == 12u */
+    "Usr"
+};
+
+static void Scale_BuildTable(uint32 mask);
+
+
+/*******************************************************************************
+* Function Name: Scale_Select
+********************************************************************************
+*
+* Summary:
+*  Selects a scale and rebuilds the snap table. Takes a few hundred
+*  microseconds, so it is meant for user interface rate changes only.
+*
+* Parameters:
+*  scale:  SCALE_CHROMATIC .. SCALE_COUNT - 1
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void Scale_Select(uint8 scale)
+{
+    if(scale >= SCALE_COUNT)
+    {
+        scale = SCALE_CHROMATIC;
+    }
+
+    selectedScale = scale;
+    Scale_BuildTable(Scale_GetMask(scale));
+}
+
+
+/*******************************************************************************
+* Function Name: Scale_Next
+********************************************************************************
+*
+* Summary:
+*  Selects the next scale, wrapping back to chromatic after the last one.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  The newly selected scale.
+*
+*******************************************************************************/
+uint8 Scale_Next(void)
+{
+    Scale_Select(selectedScale + 1u);
+
+    return selectedScale;
+}
+
+
+/*******************************************************************************
+* Function Name: Scale_GetSelected
+********************************************************************************
+*
+* Summary:
+*  Returns the selected scale.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  SCALE_CHROMATIC .. SCALE_COUNT - 1
+*
+*******************************************************************************/
+uint8 Scale_GetSelected(void)
+{
+    return selectedScale;
+}
+
+
+/*******************************************************************************
+* Function Name: Scale_GetName
+********************************************************************************
+*
+* Summary:
+*  Returns the SCALE_NAME_LENGTH character display name of a scale.
+*
+* Parameters:
+*  scale:  SCALE_CHROMATIC .. SCALE_COUNT - 1
+*
+* Return:
+*  Zero terminated name.
+*
+*******************************************************************************/
+char8 const * Scale_GetName(uint8 scale)
+{
+    if(scale >= SCALE_COUNT)
+    {
+        scale = SCALE_CHROMATIC;
+    }
+
+    return scaleNames[scale];
+}
+
+
+/*******************************************************************************
+* Function Name: Scale_SetCustomMask
+********************************************************************************
+*
+* Summary:
+*  Sets the notes of the user scale. An empty mask is ignored. The snap
+*  table is rebuilt if the user scale is selected.
+*
+* Parameters:
+*  mask:  NUMBER_NOTES_PER_VOLT bit note mask
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void Scale_SetCustomMask(uint32 mask)
+{
+    mask &= SCALE_MASK_ALL;
+
+    if(0u != mask)
+    {
+        customMask = mask;
+
+        if(SCALE_CUSTOM == selectedScale)
+        {
+            Scale_BuildTable(customMask);
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: Scale_Snap
+********************************************************************************
+*
+* Summary:
+*  Moves a chromatic step to the nearest step of the selected scale.
+*
+* Parameters:
+*  step:   nearest chromatic step, from Quantizer_Quantize()
+*  error:  quantizer error of that step, its sign tells on which side of the
+*          step the input lies
+*
+* Return:
+*  Nearest allowed step.
+*
+*******************************************************************************/
+uint32 Scale_Snap(uint32 step, int32 error)
+{
+    return snapTable[(step << 1u) + ((error >= 0) ? 1u : 0u)];
+}
+
+
+/*******************************************************************************
+* Function Name: Scale_GetMask
+********************************************************************************
+*
+* Summary:
+*  Returns the note mask of a scale, e.g. to show its notes.
+*
+* Parameters:
+*  scale:  SCALE_CHROMATIC .. SCALE_COUNT - 1
+*
+* Return:
+*  NUMBER_NOTES_PER_VOLT bit note mask.
+*
+*******************************************************************************/
+uint32 Scale_GetMask(uint8 scale)
+{
+    uint32 mask;
+
+    switch(scale)
+    {
+#if(NUMBER_NOTES_PER_VOLT == 12u)
+        case SCALE_MAJOR:
+            mask = SCALE_MASK_MAJOR;
+            break;
+        case SCALE_MINOR:
+            mask = SCALE_MASK_MINOR;
+            break;
+        case SCALE_MAJOR_PENTA:
+            mask = SCALE_MASK_MAJOR_PENTA;
+            break;
+        case SCALE_MINOR_PENTA:
+            mask = SCALE_MASK_MINOR_PENTA;
+            break;
+#endif /* NUMBER_NOTES_PER_VOLT == 12u */
+        case SCALE_CUSTOM:
+            mask = customMask;
+            break;
+        default:
+            mask = SCALE_MASK_ALL;
+            break;
+    }
+
+    return mask;
+}
+
+
+/*******************************************************************************
+* Function Name: Scale_BuildTable
+********************************************************************************
+*
+* Summary:
+*  Fills the snap table for a note mask. For each half step entry the
+*  closest allowed step above and below are searched; the input position is
+*  taken a quarter step below or above the chromatic step, which can never
+*  be a tie.
+*
+* Parameters:
+*  mask:  NUMBER_NOTES_PER_VOLT bit note mask
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+static void Scale_BuildTable(uint32 mask)
+{
+    uint8 entry;
+    uint8 step;
+    uint8 below;
+    uint8 above;
+    int16 position;
+    uint8 allowed[NUMBER_NOTE_PERFECT_STEPS + 1u];
+
+    if(0u == (mask & SCALE_MASK_ALL))
+    {
+        mask = SCALE_MASK_ALL;
+    }
+
+    for(step = 0u; step <= NUMBER_NOTE_PERFECT_STEPS; step++)
+    {
+        allowed[step] = (0u != (mask & ((uint32) 1u << (step % NUMBER_NOTES_PER_VOLT)))) ? 1u : 0u;
+    }
+
+    for(entry = 0u; entry < SCALE_SNAP_TABLE_SIZE; entry++)
+    {
+        step = entry >> 1u;
+
+        /* Closest allowed step at or below, and at or above (0xFF if none) */
+        below = step;
+        while((below != 0xFFu) && (0u == allowed[below]))
+        {
+            below = (0u == below) ? 0xFFu : (below - 1u);
+        }
+
+        above = step;
+        while((above <= NUMBER_NOTE_PERFECT_STEPS) && (0u == allowed[above]))
+        {
+            above++;
+        }
+
+        if(0xFFu == below)
+        {
+            snapTable[entry] = above;
+        }
+        else if(above > NUMBER_NOTE_PERFECT_STEPS)
+        {
+            snapTable[entry] = below;
+        }
+        else
+        {
+            /* Input position in quarter steps, a quarter below or above step */
+            position = ((int16) step << 2) + (((entry & 1u) != 0u) ? 1 : -1);
+
+            snapTable[entry] = ((position - ((int16) below << 2)) < (((int16) above << 2) - position)) ?
+                               below : above;
+        }
+    }
+}
+
+/* [] END OF FILE */
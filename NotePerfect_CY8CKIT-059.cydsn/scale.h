@@ -0,0 +1,65 @@
+/******************************************************************************
+* File Name: scale.h
+*
+* Version 1.0
+*
+* Description:
+* This file contains the constants and function prototypes for the
+* NotePerfect scale engine.
+*
+*******************************************************************************/
+
+#if !defined(SCALE_H)
+#define SCALE_H
+
+#include "hal.h"
+#include "notetable.h"
+
+/* Scale notes are given as a mask of NUMBER_NOTES_PER_VOLT bits per octave
+* (1 V). Bit n allows the note n steps above each whole volt (C at 0 V).
+*/
+#define SCALE_MASK_ALL              ((uint32)((1uLL << NUMBER_NOTES_PER_VOLT) - 1u))
+
+/* 12-TET note masks */
+#define SCALE_MASK_MAJOR            (0xAB5u)    /* C D E F G A B */
+#define SCALE_MASK_MINOR            (0x5ADu)    /* C D Eb F G Ab Bb */
+#define SCALE_MASK_MAJOR_PENTA      (0x295u)    /* C D E G A */
+#define SCALE_MASK_MINOR_PENTA      (0x4A9u)    /* C Eb F G Bb */
+
+/* Power-up value of the user scale (whole tone) */
+#define SCALE_MASK_CUSTOM_DEFAULT   (0x555u)
+
+/* Scale selections (cycled with the Misc CapSense button) */
+#define SCALE_CHROMATIC             (0u)
+#if(NUMBER_NOTES_PER_VOLT == 12u)
+    #define SCALE_MAJOR             (1u)
+    #define SCALE_MINOR             (2u)
+    #define SCALE_MAJOR_PENTA       (3u)
+    #define SCALE_MINOR_PENTA       (4u)
+    #define SCALE_CUSTOM            (5u)
+    #define SCALE_COUNT             (6u)
+#else
+    /* The named scales only exist for 12 notes per volt */
+    #define SCALE_CUSTOM            (1u)
+    #define SCALE_COUNT             (2u)
+#endif /* NUMBER_NOTES_PER_VOLT == 12u */
+
+/* Length of the scale names returned by Scale_GetName() */
+#define SCALE_NAME_LENGTH           (3u)
+
+
+/***************************************
+*        Function Prototypes
+***************************************/
+
+void Scale_Select(uint8 scale);
+uint8 Scale_Next(void);
+uint8 Scale_GetSelected(void);
+char8 const * Scale_GetName(uint8 scale);
+uint32 Scale_GetMask(uint8 scale);
+void Scale_SetCustomMask(uint32 mask);
+uint32 Scale_Snap(uint32 step, int32 error);
+
+#endif /* SCALE_H */
+
+/* [] END OF FILE */
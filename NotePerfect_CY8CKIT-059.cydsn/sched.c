@@ -0,0 +1,100 @@
+/******************************************************************************
+* File Name: sched.c
+*
+* Version 1.0
+*
+* Description:
+* This file contains a small cooperative scheduler. The task table is in
+* priority order, highest first. Sched_RunNext() runs the first ready task
+* and returns, so after every task, however unimportant, the search starts
+* again from the top: a task can only run when no task above it is ready,
+* and waits at most for the one task that is running to finish.
+*
+* Tasks run to completion and are not preempted; each one is kept short and
+* gives the CPU back as soon as it has done one unit of work. Periodic
+* tasks are counted in SysTick ticks, so when the tick is stopped (idle
+* mode) only the tasks with a ready function still run.
+*
+*******************************************************************************/
+
+#include "sched.h"
+#include "stddef.h"
+
+/* Task table, in priority order */
+static Sched_TASK const * taskTable = NULL;
+static uint8 taskCount = 0u;
+
+/* Tick count of the last run of each task */
+static uint32 lastRun[SCHED_MAX_TASKS];
+
+
+/*******************************************************************************
+* Function Name: Sched_Start
+********************************************************************************
+*
+* Summary:
+*  Installs the task table. Periodic tasks are first due one period later.
+*  Must be called after Tick_Start().
+*
+* Parameters:
+*  tasks:  task table, highest priority first; must stay valid
+*  count:  number of tasks, at most SCHED_MAX_TASKS
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void Sched_Start(Sched_TASK const tasks[], uint8 count)
+{
+    uint32 now = Tick_GetCount();
+    uint8 i;
+
+    taskTable = tasks;
+    taskCount = (count > SCHED_MAX_TASKS) ? SCHED_MAX_TASKS : count;
+
+    for(i = 0u; i < taskCount; i++)
+    {
+        lastRun[i] = now;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: Sched_RunNext
+********************************************************************************
+*
+* Summary:
+*  Runs the highest priority task that is ready. Called in a loop by
+*  main().
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  Index of the task that ran, SCHED_NONE if none was ready.
+*
+*******************************************************************************/
+uint8 Sched_RunNext(void)
+{
+    Sched_TASK const * task;
+    uint32 now = Tick_GetCount();
+    uint8 i;
+
+    for(i = 0u; i < taskCount; i++)
+    {
+        task = &taskTable[i];
+
+        if(((0u == task->periodTicks) || ((now - lastRun[i]) >= task->periodTicks)) &&
+           ((NULL == task->ready) || (0u != task->ready())))
+        {
+            lastRun[i] = now;
+            task->run();
+
+            return i;
+        }
+    }
+
+    return SCHED_NONE;
+}
+
+/* [] END OF FILE */
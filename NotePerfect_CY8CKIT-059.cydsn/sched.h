@@ -0,0 +1,59 @@
+/******************************************************************************
+* File Name: sched.h
+*
+* Version 1.0
+*
+* Description:
+* This file contains the constants, task record and function prototypes of
+* the cooperative task scheduler.
+*
+* A ready task waits at most for the one task that is running, as long as
+* every task returns after one short unit of work. A few front panel
+* actions do not, and hold every task up until they return:
+*
+*  - calibration mode (Calib_Run(), CALIB_ENABLE), about half a minute; the
+*    outputs are parked meanwhile,
+*  - an ADC profile or idle configuration switch (Profile_SetAdcConfig()),
+*    a few conversions while the filters are reseeded,
+*  - saving the profile (PROFILE_SAVE), one EEPROM byte write.
+*
+*******************************************************************************/
+
+#if !defined(SCHED_H)
+#define SCHED_H
+
+#include <device.h>
+#include "tick.h"
+
+/* Largest task table accepted by Sched_Start() */
+#define SCHED_MAX_TASKS             (8u)
+
+/* Returned by Sched_RunNext() when no task was ready */
+#define SCHED_NONE                  (0xFFu)
+
+
+/***************************************
+*        Data Struct Definition
+***************************************/
+
+/* One task. A task is ready when its period has passed (0 = no period) and
+* its ready function, if any, returns non-zero.
+*/
+typedef struct
+{
+    void (* run)(void);             /* runs to completion */
+    uint8 (* ready)(void);          /* NULL = ready whenever due */
+    uint32 periodTicks;             /* SysTick ticks between two runs */
+} Sched_TASK;
+
+
+/***************************************
+*        Function Prototypes
+***************************************/
+
+void Sched_Start(Sched_TASK const tasks[], uint8 count);
+uint8 Sched_RunNext(void);
+
+#endif /* SCHED_H */
+
+/* [] END OF FILE */
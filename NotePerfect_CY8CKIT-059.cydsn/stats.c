@@ -0,0 +1,196 @@
+/******************************************************************************
+* File Name: stats.c
+*
+* Version 1.0
+*
+* Description:
+* This file contains the correction statistics. For every quantized sample
+* the correction applied to the input, the output note minus the input, is
+* converted to cents and counted in a small fixed-bin histogram together
+* with the running sum and the largest correction of the channel.
+*
+* With the chromatic scale the correction is the opposite of the detuning
+* of the source, so a mean that moves away from zero points at a drifting
+* oscillator and a wide histogram at an out-of-tune sequencer. With other
+* scales the snapping to the scale is part of the correction.
+*
+* The error from the quantizer is a step fraction scaled by 2^32; only its
+* top 16 bits are used, so the conversion to cents stays in 32-bit
+* arithmetic: one multiply, one divide for the bin and a few compares per
+* sample.
+*
+*******************************************************************************/
+
+#include "stats.h"
+
+#if(STATS_ENABLE == 1u)
+    /* Statistics of each channel */
+    static Stats_HISTOGRAM histograms[STATS_CHANNELS];
+#endif /* STATS_ENABLE == 1u */
+
+
+/*******************************************************************************
+* Function Name: Stats_Reset
+********************************************************************************
+*
+* Summary:
+*  Clears the statistics of every channel.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void Stats_Reset(void)
+{
+#if(STATS_ENABLE == 1u)
+    uint8 channel;
+    uint8 bin;
+
+    for(channel = 0u; channel < STATS_CHANNELS; channel++)
+    {
+        for(bin = 0u; bin < STATS_BINS; bin++)
+        {
+            histograms[channel].bins[bin] = 0u;
+        }
+        histograms[channel].sum = 0;
+        histograms[channel].count = 0u;
+        histograms[channel].maxCents = 0u;
+    }
+#endif /* STATS_ENABLE == 1u */
+}
+
+
+/*******************************************************************************
+* Function Name: Stats_Record
+********************************************************************************
+*
+* Summary:
+*  Counts the correction of one quantized sample.
+*
+* Parameters:
+*  channel:  input channel, 0 .. STATS_CHANNELS - 1
+*  note:     output step, after scale and hysteresis
+*  step:     nearest chromatic step of the input
+*  error:    quantizer error of that step
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void Stats_Record(uint8 channel, uint32 note, uint32 step, int32 error)
+{
+#if(STATS_ENABLE == 1u)
+    Stats_HISTOGRAM * histogram = &histograms[channel];
+    int32 cents;
+    int32 offset;
+    uint32 bin;
+    uint8 i;
+
+    /* Output minus input, the error is the input position past the step;
+     * rounded to the nearest cent */
+    cents = ((int32)(note - step) * STATS_CENTS_PER_STEP) -
+            ((((error >> 16) * STATS_CENTS_PER_STEP) + 0x8000) >> 16);
+
+    offset = cents + STATS_RANGE_CENTS;
+    if(offset < 0)
+    {
+        bin = 0u;
+    }
+    else
+    {
+        bin = (uint32) offset / (uint32) STATS_BIN_CENTS;
+        bin = (bin >= STATS_BINS) ? (STATS_BINS - 1u) : bin;
+    }
+    histogram->bins[bin]++;
+    histogram->sum += cents;
+
+    cents = (cents < 0) ? -cents : cents;
+    if((uint32) cents > histogram->maxCents)
+    {
+        histogram->maxCents = (uint16) cents;
+    }
+
+    histogram->count++;
+    if(histogram->count >= STATS_WINDOW)
+    {
+        for(i = 0u; i < STATS_BINS; i++)
+        {
+            histogram->bins[i] >>= 1;
+        }
+        histogram->sum /= 2;
+        histogram->count >>= 1;
+    }
+#else
+    (void) channel;
+    (void) note;
+    (void) step;
+    (void) error;
+#endif /* STATS_ENABLE == 1u */
+}
+
+
+/*******************************************************************************
+* Function Name: Stats_GetHistogram
+********************************************************************************
+*
+* Summary:
+*  Copies the statistics of one channel.
+*
+* Parameters:
+*  channel:    input channel, 0 .. STATS_CHANNELS - 1
+*  histogram:  receives the statistics (all zero with STATS_ENABLE off)
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void Stats_GetHistogram(uint8 channel, Stats_HISTOGRAM * histogram)
+{
+#if(STATS_ENABLE == 1u)
+    *histogram = histograms[channel];
+#else
+    uint8 bin;
+
+    (void) channel;
+    for(bin = 0u; bin < STATS_BINS; bin++)
+    {
+        histogram->bins[bin] = 0u;
+    }
+    histogram->sum = 0;
+    histogram->count = 0u;
+    histogram->maxCents = 0u;
+#endif /* STATS_ENABLE == 1u */
+}
+
+
+/*******************************************************************************
+* Function Name: Stats_GetMean
+********************************************************************************
+*
+* Summary:
+*  Returns the mean correction of one channel.
+*
+* Parameters:
+*  channel:  input channel, 0 .. STATS_CHANNELS - 1
+*
+* Return:
+*  Mean correction in cents, 0 before the first sample.
+*
+*******************************************************************************/
+int32 Stats_GetMean(uint8 channel)
+{
+#if(STATS_ENABLE == 1u)
+    Stats_HISTOGRAM const * histogram = &histograms[channel];
+
+    return (0u != histogram->count) ? (histogram->sum / (int32) histogram->count) : 0;
+#else
+    (void) channel;
+
+    return 0;
+#endif /* STATS_ENABLE == 1u */
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,68 @@
+/******************************************************************************
+* File Name: stats.h
+*
+* Version 1.0
+*
+* Description:
+* This file contains the constants, histogram record and function
+* prototypes of the correction statistics.
+*
+*******************************************************************************/
+
+#if !defined(STATS_H)
+#define STATS_H
+
+#include "hal.h"
+#include "notetable.h"
+
+/* 1 = record the correction of every quantized sample. Costs a few integer
+* operations per sample, so it can stay on; with 0u Stats_Record() is an
+* empty call and the statistics page is left out.
+*/
+#define STATS_ENABLE                (1u)
+
+/* One histogram per sampled input */
+#define STATS_CHANNELS              (HAL_CHANNELS)
+
+/* Size of one step in cents */
+#define STATS_CENTS_PER_STEP        ((int32)(1200u / NUMBER_NOTES_PER_VOLT))
+
+/* Histogram bins and their width (in cents). The bins span
+* +/- STATS_RANGE_CENTS; larger corrections are counted in the outer bins.
+*/
+#define STATS_BINS                  (16u)
+#define STATS_BIN_CENTS             (6)
+#define STATS_RANGE_CENTS           (((int32) STATS_BINS * STATS_BIN_CENTS) / 2)
+
+/* Samples after which the bins, sum and count are halved, so the histogram
+* follows drift instead of averaging it away since power-up.
+*/
+#define STATS_WINDOW                (4096u)
+
+
+/***************************************
+*        Data Struct Definition
+***************************************/
+
+/* Correction statistics of one channel, in cents */
+typedef struct
+{
+    uint16 bins[STATS_BINS];    /* bin 0 is the most negative correction */
+    int32 sum;
+    uint32 count;
+    uint16 maxCents;            /* largest correction either way since Stats_Reset() */
+} Stats_HISTOGRAM;
+
+
+/***************************************
+*        Function Prototypes
+***************************************/
+
+void Stats_Reset(void);
+void Stats_Record(uint8 channel, uint32 note, uint32 step, int32 error);
+void Stats_GetHistogram(uint8 channel, Stats_HISTOGRAM * histogram);
+int32 Stats_GetMean(uint8 channel);
+
+#endif /* STATS_H */
+
+/* [] END OF FILE */
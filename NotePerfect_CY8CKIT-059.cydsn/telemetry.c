@@ -0,0 +1,332 @@
+/******************************************************************************
+* File Name: telemetry.c
+*
+* Version 1.0
+*
+* Description:
+* This file contains the binary sample telemetry. For every filtered batch
+* the main loop posts the raw conversions, the filtered counts and the
+* step; Telemetry_Post() packs them into one compact frame (see
+* telemetry.h) and appends it to a RAM buffer. DMA_TX moves the buffer into
+* the UART TX FIFO, paced by the FIFO-not-full request, while the main loop
+* fills the other half of a ping-pong pair. The CPU only formats a few
+* bytes per conversion and reprograms the DMA once per buffer, and never
+* waits for the UART: when both halves are full the frame is dropped and a
+* gap is left in the sequence numbers.
+*
+* The decimation keeps every n-th conversion, counted across batches, so
+* the same stream runs from a slow overview up to every conversion. At the
+* 20-bit ADC rate a full-rate stream is a few kB/s, well within the KitProg
+* USB-UART bridge.
+*
+*******************************************************************************/
+
+#include "telemetry.h"
+#include "string.h"
+
+#if(TELEMETRY_ENABLE == 1u)
+
+    /* DMA_TX channel configuration: one byte per FIFO-not-full request */
+    #define TELEMETRY_DMA_BYTES_PER_BURST   (1u)
+    #define TELEMETRY_DMA_REQUEST_PER_BURST (1u)
+    #define TELEMETRY_DMA_SRC_BASE          (CYDEV_SRAM_BASE)
+    #define TELEMETRY_DMA_DST_BASE          (CYDEV_PERIPH_BASE)
+
+    /* Ping-pong buffers, filled by the main loop and sent by DMA */
+    static uint8 buffer[2u][TELEMETRY_BUFFER_BYTES];
+    static uint8 fillHalf = 0u;
+    static uint16 fillLength = 0u;
+
+    /* Set by the main loop when DMA is started, cleared by the ISR */
+    static volatile uint8 txBusy = 0u;
+
+    static uint8 dmaChannel;
+    static uint8 dmaTd;
+
+    /* Conversions kept and conversions left to skip */
+    static uint8 keepEvery = TELEMETRY_DECIMATION;
+    static uint8 skip = 0u;
+
+    static uint8 sequence = 0u;
+    static uint32 drops = 0u;
+
+    static void Telemetry_Kick(void);
+    static void Telemetry_Put24(uint8 bytes[], int32 value);
+
+#endif /* TELEMETRY_ENABLE == 1u */
+
+
+/*******************************************************************************
+* Function Name: Telemetry_Start
+********************************************************************************
+*
+* Summary:
+*  Starts the UART and sets up the DMA channel and the completion interrupt.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void Telemetry_Start(void)
+{
+#if(TELEMETRY_ENABLE == 1u)
+    UART_Start();
+
+    dmaChannel = DMA_TX_DmaInitialize(TELEMETRY_DMA_BYTES_PER_BURST, TELEMETRY_DMA_REQUEST_PER_BURST,
+                                      HI16(TELEMETRY_DMA_SRC_BASE), HI16(TELEMETRY_DMA_DST_BASE));
+    dmaTd = CyDmaTdAllocate();
+
+    fillHalf = 0u;
+    fillLength = 0u;
+    txBusy = 0u;
+    skip = 0u;
+
+    isr_DMA_TX_StartEx(Telemetry_DmaIsr);
+#endif /* TELEMETRY_ENABLE == 1u */
+}
+
+
+/*******************************************************************************
+* Function Name: Telemetry_SetDecimation
+********************************************************************************
+*
+* Summary:
+*  Selects the rate of the stream.
+*
+* Parameters:
+*  decimation:  1 to send every conversion, n every n-th, 0 to stop
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void Telemetry_SetDecimation(uint8 decimation)
+{
+#if(TELEMETRY_ENABLE == 1u)
+    keepEvery = decimation;
+    skip = 0u;
+#else
+    (void) decimation;
+#endif /* TELEMETRY_ENABLE == 1u */
+}
+
+
+/*******************************************************************************
+* Function Name: Telemetry_Post
+********************************************************************************
+*
+* Summary:
+*  Queues the frame of one filtered batch, with the raw conversions the
+*  decimation keeps; nothing is queued if it keeps none. Returns at once;
+*  the frame is dropped if the queue is full.
+*
+* Parameters:
+*  channel:   sampler channel of the batch
+*  samples:   raw ADC counts of the batch
+*  count:     number of samples
+*  filtered:  filter output after the batch
+*  step:      NotePerfect step number of the output
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void Telemetry_Post(uint8 channel, int32 const samples[], uint8 count, int32 filtered, uint32 step)
+{
+#if(TELEMETRY_ENABLE == 1u)
+    uint8 frame[TELEMETRY_MAX_FRAME_BYTES];
+    uint16 length = TELEMETRY_HEADER_BYTES;
+    uint8 kept = 0u;
+    uint8 sum = 0u;
+    uint8 i;
+
+    if(0u == keepEvery)
+    {
+        return;
+    }
+
+    for(i = 0u; (i < count) && (kept < TELEMETRY_MAX_SAMPLES); i++)
+    {
+        if(0u == skip)
+        {
+            Telemetry_Put24(&frame[length], samples[i]);
+            length += TELEMETRY_VALUE_BYTES;
+            kept++;
+            skip = keepEvery - 1u;
+        }
+        else
+        {
+            skip--;
+        }
+    }
+
+    if(0u == kept)
+    {
+        return;
+    }
+
+    frame[0u] = TELEMETRY_SYNC;
+    frame[1u] = ((0u != channel) ? TELEMETRY_CHANNEL_BIT : 0u) | kept;
+    frame[2u] = sequence;
+    frame[3u] = (uint8) step;
+    Telemetry_Put24(&frame[4u], filtered);
+
+    for(i = 1u; i < length; i++)
+    {
+        sum += frame[i];
+    }
+    frame[length] = (uint8)(0u - sum);
+    length += TELEMETRY_CHECKSUM_BYTES;
+
+    sequence++;
+
+    Telemetry_Kick();
+    if((fillLength + length) > TELEMETRY_BUFFER_BYTES)
+    {
+        drops++; /* both halves busy, the UART is behind */
+        return;
+    }
+    (void) memcpy(&buffer[fillHalf][fillLength], frame, length);
+    fillLength += length;
+    Telemetry_Kick();
+#else
+    (void) channel;
+    (void) samples;
+    (void) count;
+    (void) filtered;
+    (void) step;
+#endif /* TELEMETRY_ENABLE == 1u */
+}
+
+
+/*******************************************************************************
+* Function Name: Telemetry_Task
+********************************************************************************
+*
+* Summary:
+*  Applies a decimation byte sent by the host and starts DMA on the queued
+*  frames if it is idle. Called on every main loop pass.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void Telemetry_Task(void)
+{
+#if(TELEMETRY_ENABLE == 1u)
+    while(0u != (UART_ReadRxStatus() & UART_RX_STS_FIFO_NOTEMPTY))
+    {
+        Telemetry_SetDecimation(UART_ReadRxData());
+    }
+
+    Telemetry_Kick();
+#endif /* TELEMETRY_ENABLE == 1u */
+}
+
+
+/*******************************************************************************
+* Function Name: Telemetry_GetDrops
+********************************************************************************
+*
+* Summary:
+*  Returns the number of frames dropped because the UART fell behind.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  Dropped frames since Telemetry_Start().
+*
+*******************************************************************************/
+uint32 Telemetry_GetDrops(void)
+{
+#if(TELEMETRY_ENABLE == 1u)
+    return drops;
+#else
+    return 0u;
+#endif /* TELEMETRY_ENABLE == 1u */
+}
+
+
+#if(TELEMETRY_ENABLE == 1u)
+
+    /*******************************************************************************
+    * Function Name: Telemetry_Kick
+    ********************************************************************************
+    *
+    * Summary:
+    *  If DMA is idle, hands it the half being filled and switches the main
+    *  loop to the other half.
+    *
+    * Parameters:
+    *  None.
+    *
+    * Return:
+    *  None.
+    *
+    *******************************************************************************/
+    static void Telemetry_Kick(void)
+    {
+        if((0u != txBusy) || (0u == fillLength))
+        {
+            return;
+        }
+
+        txBusy = 1u;
+        CyDmaTdSetConfiguration(dmaTd, fillLength, CY_DMA_DISABLE_TD,
+                                CY_DMA_TD_INC_SRC_ADR | DMA_TX__TD_TERMOUT_EN);
+        CyDmaTdSetAddress(dmaTd, LO16((uint32) buffer[fillHalf]), LO16((uint32) UART_TXDATA_PTR));
+        CyDmaChSetInitialTd(dmaChannel, dmaTd);
+        (void) CyDmaChEnable(dmaChannel, 1u);
+
+        fillHalf ^= 1u;
+        fillLength = 0u;
+    }
+
+
+    /*******************************************************************************
+    * Function Name: Telemetry_Put24
+    ********************************************************************************
+    *
+    * Summary:
+    *  Stores the low 24 bits of a value, little endian.
+    *
+    * Parameters:
+    *  bytes:  destination, 3 bytes
+    *  value:  signed value within 24 bits
+    *
+    * Return:
+    *  None.
+    *
+    *******************************************************************************/
+    static void Telemetry_Put24(uint8 bytes[], int32 value)
+    {
+        bytes[0u] = LO8((uint32) value);
+        bytes[1u] = LO8((uint32) value >> 8);
+        bytes[2u] = LO8((uint32) value >> 16);
+    }
+
+
+    /*******************************************************************************
+    * Function Name: Telemetry_DmaIsr
+    ********************************************************************************
+    *
+    * Summary:
+    *  DMA_TX completion handler. The last byte of the buffer is in the UART
+    *  FIFO, so the next buffer can be started.
+    *
+    *******************************************************************************/
+    CY_ISR(Telemetry_DmaIsr)
+    {
+        txBusy = 0u;
+    }
+
+#endif /* TELEMETRY_ENABLE == 1u */
+
+/* [] END OF FILE */
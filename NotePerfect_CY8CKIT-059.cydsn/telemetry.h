@@ -0,0 +1,77 @@
+/******************************************************************************
+* File Name: telemetry.h
+*
+* Version 1.0
+*
+* Description:
+* This file contains the constants, frame layout and function prototypes of
+* the binary sample telemetry.
+*
+*******************************************************************************/
+
+#if !defined(TELEMETRY_H)
+#define TELEMETRY_H
+
+#include <device.h>
+
+/* Set to 1u to stream the samples out of a UART. Requires a UART component
+* named UART (8N1, TX and RX, TX interrupt source "FIFO not full" on its
+* tx_interrupt terminal), a DMA component named DMA_TX with its drq on that
+* terminal and an Interrupt component named isr_DMA_TX on the DMA nrq
+* terminal. Route UART tx to P12[7] for the KitProg USB-UART bridge.
+*/
+#define TELEMETRY_ENABLE            (0u)
+
+/* Power-up decimation: 1 sends every conversion, n every n-th, 0 nothing.
+* The host changes it at run time by sending a single byte with the new
+* value.
+*/
+#define TELEMETRY_DECIMATION        (1u)
+
+/* RAM buffer of each DMA ping-pong half (in bytes) */
+#define TELEMETRY_BUFFER_BYTES      (128u)
+
+/* Frame layout, all values little endian:
+*   0       TELEMETRY_SYNC
+*   1       bit 7: channel, bits 3..0: number of raw conversions n
+*   2       frame sequence number (gaps are frames dropped on overflow)
+*   3       step index
+*   4..6    filtered counts, signed 24-bit
+*   7..     n raw ADC_GetResult32() counts, signed 24-bit each
+*   last    checksum: the bytes after the sync byte add up to 0 (mod 256)
+*/
+#define TELEMETRY_SYNC              (0xA5u)
+#define TELEMETRY_CHANNEL_BIT       (0x80u)
+#define TELEMETRY_COUNT_MASK        (0x0Fu)
+#define TELEMETRY_HEADER_BYTES      (7u)
+#define TELEMETRY_VALUE_BYTES       (3u)
+#define TELEMETRY_CHECKSUM_BYTES    (1u)
+
+/* Most raw conversions in one frame */
+#define TELEMETRY_MAX_SAMPLES       (TELEMETRY_COUNT_MASK)
+#define TELEMETRY_MAX_FRAME_BYTES   (TELEMETRY_HEADER_BYTES + \
+                                     (TELEMETRY_MAX_SAMPLES * TELEMETRY_VALUE_BYTES) + \
+                                     TELEMETRY_CHECKSUM_BYTES)
+
+#if(TELEMETRY_MAX_FRAME_BYTES > TELEMETRY_BUFFER_BYTES)
+    #error "A telemetry frame does not fit in TELEMETRY_BUFFER_BYTES"
+#endif /* TELEMETRY_MAX_FRAME_BYTES > TELEMETRY_BUFFER_BYTES */
+
+
+/***************************************
+*        Function Prototypes
+***************************************/
+
+void Telemetry_Start(void);
+void Telemetry_SetDecimation(uint8 decimation);
+void Telemetry_Post(uint8 channel, int32 const samples[], uint8 count, int32 filtered, uint32 step);
+void Telemetry_Task(void);
+uint32 Telemetry_GetDrops(void);
+
+#if(TELEMETRY_ENABLE == 1u)
+    CY_ISR_PROTO(Telemetry_DmaIsr);
+#endif /* TELEMETRY_ENABLE == 1u */
+
+#endif /* TELEMETRY_H */
+
+/* [] END OF FILE */
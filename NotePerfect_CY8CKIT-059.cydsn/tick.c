@@ -0,0 +1,140 @@
+/******************************************************************************
+* File Name: tick.c
+*
+* Version 1.0
+*
+* Description:
+* This file contains the SysTick time base. Every TICK_PERIOD_US the tick
+* advances the LCD flush state machine by one nibble, so LCD updates cost
+* the main loop a buffer write instead of several milliseconds of inline
+* CyDelayUs() calls. With OUTPUT_GLIDE the tick also steps the output glide.
+*
+*******************************************************************************/
+
+#include "tick.h"
+#include "perf.h"
+#include "output.h"
+
+/* Number of ticks since Tick_Start() */
+static volatile uint32 tickCount = 0u;
+
+static void Tick_Isr(void);
+
+
+/*******************************************************************************
+* Function Name: Tick_Start
+********************************************************************************
+*
+* Summary:
+*  Starts SysTick at TICK_PERIOD_US and registers the tick callback. Must be
+*  called after LCD_Start(), whose initialization uses the blocking API, or
+*  before LCD_StartBackground(), whose initialization runs from the tick.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void Tick_Start(void)
+{
+    tickCount = 0u;
+
+    CySysTickStart();
+    CySysTickSetReload(TICK_RELOAD);
+    CySysTickClear();
+    (void) CySysTickSetCallback(TICK_CALLBACK_SLOT, &Tick_Isr);
+}
+
+
+/*******************************************************************************
+* Function Name: Tick_Suspend
+********************************************************************************
+*
+* Summary:
+*  Stops the tick interrupt so the CPU is not woken every TICK_PERIOD_US.
+*  The tick count stands still and the LCD is not flushed until
+*  Tick_Resume(). Used by the idle mode.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void Tick_Suspend(void)
+{
+    CySysTickDisableInterrupt();
+}
+
+
+/*******************************************************************************
+* Function Name: Tick_Resume
+********************************************************************************
+*
+* Summary:
+*  Restarts the tick interrupt after Tick_Suspend(). The count continues from
+*  where it stopped.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void Tick_Resume(void)
+{
+    CySysTickClear();
+    CySysTickEnableInterrupt();
+}
+
+
+/*******************************************************************************
+* Function Name: Tick_GetCount
+********************************************************************************
+*
+* Summary:
+*  Returns the number of ticks since Tick_Start(). Wraps after 2^32 ticks.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  Tick count.
+*
+*******************************************************************************/
+uint32 Tick_GetCount(void)
+{
+    return tickCount;
+}
+
+
+/*******************************************************************************
+* Function Name: Tick_Isr
+********************************************************************************
+*
+* Summary:
+*  SysTick callback, runs in interrupt context every TICK_PERIOD_US.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+static void Tick_Isr(void)
+{
+    tickCount++;
+
+#if(OUTPUT_GLIDE != OUTPUT_GLIDE_OFF)
+    Output_GlideTick();
+#endif /* OUTPUT_GLIDE != OUTPUT_GLIDE_OFF */
+
+    LCD_FlushTick();
+}
+
+/* [] END OF FILE */
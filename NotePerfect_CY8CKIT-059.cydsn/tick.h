@@ -0,0 +1,39 @@
+/******************************************************************************
+* File Name: tick.h
+*
+* Version 1.0
+*
+* Description:
+* This file contains the constants and function prototypes for the SysTick
+* time base. The tick clocks the LCD frame buffer out in the background.
+*
+*******************************************************************************/
+
+#if !defined(TICK_H)
+#define TICK_H
+
+#include <device.h>
+
+/* SysTick period, one LCD nibble is clocked out per tick */
+#define TICK_PERIOD_US              (LCD_FLUSH_TICK_US)
+#define TICKS_PER_MS                (1000u / TICK_PERIOD_US)
+
+/* SysTick reload value for TICK_PERIOD_US */
+#define TICK_RELOAD                 (((BCLK__BUS_CLK__HZ / 1000000u) * TICK_PERIOD_US) - 1u)
+
+/* SysTick callback slot used by this module */
+#define TICK_CALLBACK_SLOT          (0u)
+
+
+/***************************************
+*        Function Prototypes
+***************************************/
+
+void Tick_Start(void);
+void Tick_Suspend(void);
+void Tick_Resume(void);
+uint32 Tick_GetCount(void);
+
+#endif /* TICK_H */
+
+/* [] END OF FILE */
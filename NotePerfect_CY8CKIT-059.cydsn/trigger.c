@@ -0,0 +1,160 @@
+/******************************************************************************
+* File Name: trigger.c
+*
+* Version 1.0
+*
+* Description:
+* This file contains the sample-and-hold mode. The sampler, filter and
+* quantizer keep running continuously, and the main loop arms the current
+* note with Trigger_Arm() whenever it changes. The outputs themselves are
+* only updated by the trigger edge interrupt, which writes the armed notes
+* to the outputs. All the signal work is done ahead
+* of the edge, so the trigger-to-output path is a few loads and stores in
+* the ISR and does not depend on what the main loop is doing at that time.
+*
+* The armed notes are single bytes, so the main loop can update them while the
+* ISR reads them without a critical section.
+*
+* The ISR also keeps the note each edge latched. The main loop polls
+* Trigger_GetCount() and sends those notes as MIDI from its own context, so
+* MIDI follows the edges rather than the free-running quantizer.
+*
+*******************************************************************************/
+
+#include "trigger.h"
+
+/* Note to output at the next edge, per output */
+static volatile uint8 armedNote[OUTPUT_CHANNELS];
+
+/* Note the last edge put out, per output */
+static volatile uint8 latchedNote[OUTPUT_CHANNELS];
+
+/* Number of trigger edges since Trigger_Start() */
+static volatile uint32 triggerCount = 0u;
+
+
+/*******************************************************************************
+* Function Name: Trigger_Start
+********************************************************************************
+*
+* Summary:
+*  Clears the armed notes and hooks the trigger interrupt. Does nothing but
+*  the clearing when TRIGGER_ENABLE is 0u.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void Trigger_Start(void)
+{
+    uint8 channel;
+
+    for(channel = 0u; channel < OUTPUT_CHANNELS; channel++)
+    {
+        armedNote[channel] = 0u;
+        latchedNote[channel] = 0u;
+    }
+    triggerCount = 0u;
+
+#if(TRIGGER_ENABLE == 1u)
+    (void) Trigger_In_ClearInterrupt();
+    isr_Trigger_StartEx(Trigger_Isr);
+#endif /* TRIGGER_ENABLE == 1u */
+}
+
+
+/*******************************************************************************
+* Function Name: Trigger_Arm
+********************************************************************************
+*
+* Summary:
+*  Sets the note an output takes at the next trigger edge.
+*
+* Parameters:
+*  channel:  input channel, 0 .. OUTPUT_CHANNELS - 1
+*  note:     NotePerfect step number
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void Trigger_Arm(uint8 channel, uint32 note)
+{
+    armedNote[channel] = (uint8) note;
+}
+
+
+/*******************************************************************************
+* Function Name: Trigger_GetLatched
+********************************************************************************
+*
+* Summary:
+*  Returns the note the last trigger edge put out on an output. Read after
+*  Trigger_GetCount() has moved; an edge in between only makes the note
+*  newer.
+*
+* Parameters:
+*  channel:  input channel, 0 .. OUTPUT_CHANNELS - 1
+*
+* Return:
+*  NotePerfect step number.
+*
+*******************************************************************************/
+uint32 Trigger_GetLatched(uint8 channel)
+{
+    return latchedNote[channel];
+}
+
+
+/*******************************************************************************
+* Function Name: Trigger_GetCount
+********************************************************************************
+*
+* Summary:
+*  Returns the number of trigger edges since Trigger_Start().
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  Edge count.
+*
+*******************************************************************************/
+uint32 Trigger_GetCount(void)
+{
+    return triggerCount;
+}
+
+
+#if(TRIGGER_ENABLE == 1u)
+
+    /*******************************************************************************
+    * Function Name: Trigger_Isr
+    ********************************************************************************
+    *
+    * Summary:
+    *  Trigger edge handler. Clears the pin interrupt, samples the armed
+    *  note of every output and records it for Trigger_GetLatched().
+    *
+    *******************************************************************************/
+    CY_ISR(Trigger_Isr)
+    {
+        uint8 channel;
+
+        (void) Trigger_In_ClearInterrupt();
+
+        for(channel = 0u; channel < OUTPUT_CHANNELS; channel++)
+        {
+            latchedNote[channel] = armedNote[channel];
+            Output_WriteNote(channel, latchedNote[channel]);
+        }
+
+        triggerCount++;
+    }
+
+#endif /* TRIGGER_ENABLE == 1u */
+
+/* [] END OF FILE */
@@ -0,0 +1,40 @@
+/******************************************************************************
+* File Name: trigger.h
+*
+* Version 1.0
+*
+* Description:
+* This file contains the constants and function prototypes for the external
+* trigger (sample-and-hold) input.
+*
+*******************************************************************************/
+
+#if !defined(TRIGGER_H)
+#define TRIGGER_H
+
+#include <device.h>
+#include "output.h"
+
+/* Set to 1u to update the outputs only on trigger edges. Requires a digital
+* input Pins component named Trigger_In with a rising edge interrupt and an
+* Interrupt component named isr_Trigger on its irq terminal.
+*/
+#define TRIGGER_ENABLE              (0u)
+
+
+/***************************************
+*        Function Prototypes
+***************************************/
+
+void Trigger_Start(void);
+void Trigger_Arm(uint8 channel, uint32 note);
+uint32 Trigger_GetLatched(uint8 channel);
+uint32 Trigger_GetCount(void);
+
+#if(TRIGGER_ENABLE == 1u)
+    CY_ISR_PROTO(Trigger_Isr);
+#endif /* TRIGGER_ENABLE == 1u */
+
+#endif /* TRIGGER_H */
+
+/* [] END OF FILE */
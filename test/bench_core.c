@@ -0,0 +1,391 @@
+/******************************************************************************
+* File Name: bench_core.c
+*
+* Version 1.0
+*
+* Description:
+* This file contains the trace replay benchmark of the signal core. Ramp,
+* step and noisy DC traces are run through the per-batch path of the main
+* loop (Core_Run(), trace.c) with the filter, quantizer and scale selected
+* in the project headers, and the result is compared with the exact nearest
+* allowed note.
+*
+*  - Ramp:      slow 0-5 V sweep up and down with noise. Every batch whose
+*               input is more than BENCH_GUARD_UV from a decision point
+*               must show the exact note; wrong steps are counted.
+*  - Step:      jumps between random allowed notes. Reports the mean and
+*               worst latency (samples from the jump to the first batch
+*               with the new note) and counts wrong steps after
+*               BENCH_MAX_LATENCY samples.
+*  - Noisy DC:  input parked on note centers and on decision points. The
+*               output must never move on a center and move at most once
+*               on a decision point.
+*  - Speed:     samples per second through the core on this host.
+*
+* Exits non-zero when any result is past its threshold.
+*
+*******************************************************************************/
+
+#define _POSIX_C_SOURCE     199309L
+
+#include <stdio.h>
+#include <time.h>
+#include "check.h"
+#include "trace.h"
+#include "filter.h"
+#include "quantizer.h"
+#include "scale.h"
+
+/* Samples per batch, SAMPLER_BATCH_SIZE on the target */
+#define BENCH_BATCH                 (8u)
+
+/* Inputs closer than this to a decision point are not judged: the
+* hysteresis (HYSTERESIS_WINDOW) plus the filtered noise and ramp lag.
+*/
+#define BENCH_GUARD_UV              ((HYSTERESIS_WINDOW + 5) * 1000.0)
+
+/* Ramp: batches per full-scale sweep */
+#define BENCH_RAMP_BATCHES          (32768u)
+
+/* Step: number of jumps, and batches each level is held */
+#define BENCH_STEP_COUNT            (200u)
+#define BENCH_STEP_HOLD_BATCHES     (64u)
+
+/* Noisy DC: batches per level */
+#define BENCH_DC_BATCHES            (4096u)
+
+/* Speed: total samples timed */
+#define BENCH_SPEED_SAMPLES         (1uL << 22)
+
+/* Thresholds */
+#define BENCH_MAX_WRONG_STEPS       (0u)
+#define BENCH_MAX_LATENCY           (16u)
+#define BENCH_MAX_MEAN_LATENCY      (12.0)
+#define BENCH_MAX_CENTER_MOVES      (0u)
+#define BENCH_MAX_BOUNDARY_MOVES    (1u)
+#define BENCH_MIN_SAMPLES_PER_S     (1.0e6)
+
+CHECK_DEFINE_FAILURES;
+
+static int32 block[BENCH_BATCH];
+
+
+/*******************************************************************************
+* Function Name: Bench_Fill
+********************************************************************************
+*
+* Summary:
+*  Fills one batch with a linear segment of the input plus noise.
+*
+* Parameters:
+*  from:  input at the first sample (in uV)
+*  to:    input one sample past the last one (in uV)
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+static void Bench_Fill(double from, double to)
+{
+    uint8 i;
+
+    for(i = 0u; i < BENCH_BATCH; i++)
+    {
+        block[i] = Trace_Counts(from + (((to - from) * i) / BENCH_BATCH), TRACE_NOISE_COUNTS);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: Bench_Ramp
+********************************************************************************
+*
+* Summary:
+*  Sweeps the input up and down across the full range.
+*
+* Parameters:
+*  scale:  scale to quantize to
+*
+* Return:
+*  Number of wrong steps.
+*
+*******************************************************************************/
+static uint32 Bench_Ramp(uint8 scale)
+{
+    uint32 mask = Scale_GetMask(scale);
+    double span = FULL_SCALE_MV * 1000.0;
+    double rate = span / (BENCH_RAMP_BATCHES * (double) BENCH_BATCH);
+    double input;
+    double margin;
+    uint32 wrong = 0u;
+    uint32 expected;
+    uint32 note;
+    uint32 batch;
+    uint8 pass;
+
+    Core_Start(scale, Trace_Counts(0.0, 0));
+
+    for(pass = 0u; pass < 2u; pass++)
+    {
+        for(batch = 0u; batch < BENCH_RAMP_BATCHES; batch++)
+        {
+            input = (0u == pass) ? (batch * BENCH_BATCH * rate) : (span - (batch * BENCH_BATCH * rate));
+            Bench_Fill(input, input + (((0u == pass) ? rate : -rate) * BENCH_BATCH));
+            note = Core_Run(block, BENCH_BATCH);
+
+            /* Judge on the input at the end of the batch */
+            input += ((0u == pass) ? rate : -rate) * BENCH_BATCH;
+            expected = Trace_Expected(input, mask, &margin);
+
+            if((margin > BENCH_GUARD_UV) && (note != expected))
+            {
+                wrong++;
+            }
+        }
+    }
+
+    return wrong;
+}
+
+
+/*******************************************************************************
+* Function Name: Bench_Step
+********************************************************************************
+*
+* Summary:
+*  Jumps between random allowed notes and measures the settling latency.
+*
+* Parameters:
+*  scale:       scale to quantize to
+*  meanLatency: receives the mean latency (in samples)
+*  maxLatency:  receives the worst latency (in samples)
+*
+* Return:
+*  Number of wrong steps after BENCH_MAX_LATENCY.
+*
+*******************************************************************************/
+static uint32 Bench_Step(uint8 scale, double * meanLatency, uint32 * maxLatency)
+{
+    uint32 mask = Scale_GetMask(scale);
+    uint32 wrong = 0u;
+    uint32 total = 0u;
+    uint32 latency;
+    uint32 target;
+    uint32 note;
+    uint32 batch;
+    uint32 jump;
+    double input;
+
+    *maxLatency = 0u;
+    Core_Start(scale, Trace_Counts(0.0, 0));
+
+    for(jump = 0u; jump < BENCH_STEP_COUNT; jump++)
+    {
+        do
+        {
+            target = Trace_Random(NUMBER_NOTE_PERFECT_STEPS + 1u);
+        }
+        while(0u == (mask & (1uL << (target % NUMBER_NOTES_PER_VOLT))));
+
+        input = Trace_NoteCenter(target);
+        latency = (uint32) -1;
+
+        for(batch = 0u; batch < BENCH_STEP_HOLD_BATCHES; batch++)
+        {
+            Bench_Fill(input, input);
+            note = Core_Run(block, BENCH_BATCH);
+
+            if(note == target)
+            {
+                if(latency == (uint32) -1)
+                {
+                    latency = (batch + 1u) * BENCH_BATCH;
+                }
+            }
+            else if(((batch + 1u) * BENCH_BATCH) > BENCH_MAX_LATENCY)
+            {
+                wrong++;
+            }
+            else
+            {
+                /* Still settling */
+            }
+        }
+
+        if(latency == (uint32) -1)
+        {
+            latency = BENCH_STEP_HOLD_BATCHES * BENCH_BATCH;
+        }
+
+        total += latency;
+        *maxLatency = (latency > *maxLatency) ? latency : *maxLatency;
+    }
+
+    *meanLatency = (double) total / BENCH_STEP_COUNT;
+
+    return wrong;
+}
+
+
+/*******************************************************************************
+* Function Name: Bench_Dc
+********************************************************************************
+*
+* Summary:
+*  Holds a noisy DC input and counts how often the output moves.
+*
+* Parameters:
+*  scale:  scale to quantize to
+*  input:  DC level (in uV)
+*
+* Return:
+*  Number of output changes after the first batch.
+*
+*******************************************************************************/
+static uint32 Bench_Dc(uint8 scale, double input)
+{
+    uint32 moves = 0u;
+    uint32 previous;
+    uint32 note;
+    uint32 batch;
+
+    Core_Start(scale, Trace_Counts(input, 0));
+    Bench_Fill(input, input);
+    previous = Core_Run(block, BENCH_BATCH);
+
+    for(batch = 1u; batch < BENCH_DC_BATCHES; batch++)
+    {
+        Bench_Fill(input, input);
+        note = Core_Run(block, BENCH_BATCH);
+
+        if(note != previous)
+        {
+            moves++;
+            previous = note;
+        }
+    }
+
+    return moves;
+}
+
+
+/*******************************************************************************
+* Function Name: Bench_Speed
+********************************************************************************
+*
+* Summary:
+*  Times the core on a prerecorded noisy ramp.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  Samples per second.
+*
+*******************************************************************************/
+static double Bench_Speed(void)
+{
+    static int32 trace[4096u];
+    struct timespec start;
+    struct timespec stop;
+    volatile uint32 sink = 0u;
+    uint32 sample;
+    uint32 done;
+    double seconds;
+
+    for(sample = 0u; sample < (sizeof(trace) / sizeof(trace[0])); sample++)
+    {
+        trace[sample] = Trace_Counts(((double) sample * FULL_SCALE_MV * 1000.0) / 4096.0, TRACE_NOISE_COUNTS);
+    }
+
+    Core_Start(SCALE_CHROMATIC, trace[0]);
+    (void) clock_gettime(CLOCK_MONOTONIC, &start);
+
+    for(done = 0u; done < BENCH_SPEED_SAMPLES; done += BENCH_BATCH)
+    {
+        sink += Core_Run(&trace[done & 4095u], BENCH_BATCH);
+    }
+
+    (void) clock_gettime(CLOCK_MONOTONIC, &stop);
+    (void) sink;
+
+    seconds = (double)(stop.tv_sec - start.tv_sec) + ((double)(stop.tv_nsec - start.tv_nsec) / 1e9);
+
+    return BENCH_SPEED_SAMPLES / seconds;
+}
+
+
+int main(void)
+{
+    uint8 scale;
+    uint32 note;
+    uint32 wrong;
+    uint32 moves;
+    uint32 maxLatency;
+    uint32 worstCenter;
+    uint32 worstBoundary;
+    double meanLatency;
+    double speed;
+    double margin;
+    double input;
+    uint32 point;
+
+    printf("filter type %u, %u-sample batches, +/-%d counts noise\n",
+           (unsigned) FILTER_TYPE, (unsigned) BENCH_BATCH, TRACE_NOISE_COUNTS);
+
+    for(scale = 0u; scale < SCALE_COUNT; scale++)
+    {
+        Trace_Seed(1u + scale);
+        worstCenter = 0u;
+        worstBoundary = 0u;
+
+        wrong = Bench_Ramp(scale);
+        printf("%s ramp:  %u wrong steps\n", Scale_GetName(scale), (unsigned) wrong);
+        CHECK(wrong <= BENCH_MAX_WRONG_STEPS, "%s ramp: %u wrong steps", Scale_GetName(scale), (unsigned) wrong);
+
+        wrong = Bench_Step(scale, &meanLatency, &maxLatency);
+        printf("%s step:  latency mean %.1f max %u samples, %u wrong steps\n",
+               Scale_GetName(scale), meanLatency, (unsigned) maxLatency, (unsigned) wrong);
+        CHECK(maxLatency <= BENCH_MAX_LATENCY, "%s step: latency %u samples", Scale_GetName(scale), (unsigned) maxLatency);
+        CHECK(meanLatency <= BENCH_MAX_MEAN_LATENCY, "%s step: mean latency %.1f samples", Scale_GetName(scale), meanLatency);
+        CHECK(wrong <= BENCH_MAX_WRONG_STEPS, "%s step: %u wrong steps", Scale_GetName(scale), (unsigned) wrong);
+
+        /* Every step and every half step: decision points (margin 0) and
+        * allowed note centers.
+        */
+        for(point = 0u; point <= (2u * NUMBER_NOTE_PERFECT_STEPS); point++)
+        {
+            input = (point * TRACE_STEP_UV) / 2.0;
+            note = Trace_Expected(input, Scale_GetMask(scale), &margin);
+
+            if(margin < 1.0)
+            {
+                moves = Bench_Dc(scale, input);
+                worstBoundary = (moves > worstBoundary) ? moves : worstBoundary;
+            }
+            else if(input == Trace_NoteCenter(note))
+            {
+                moves = Bench_Dc(scale, input);
+                worstCenter = (moves > worstCenter) ? moves : worstCenter;
+            }
+            else
+            {
+                /* Neither */
+            }
+        }
+
+        printf("%s dc:    %u moves on centers, %u on decision points\n",
+               Scale_GetName(scale), (unsigned) worstCenter, (unsigned) worstBoundary);
+        CHECK(worstCenter <= BENCH_MAX_CENTER_MOVES, "%s dc: %u moves on a center", Scale_GetName(scale), (unsigned) worstCenter);
+        CHECK(worstBoundary <= BENCH_MAX_BOUNDARY_MOVES, "%s dc: %u moves on a decision point",
+              Scale_GetName(scale), (unsigned) worstBoundary);
+    }
+
+    speed = Bench_Speed();
+    printf("speed: %.2f Msamples/s\n", speed / 1e6);
+    CHECK(speed >= BENCH_MIN_SAMPLES_PER_S, "speed %.0f samples/s", speed);
+
+    return CHECK_RESULT("bench_core");
+}
+
+/* [] END OF FILE */
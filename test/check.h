@@ -0,0 +1,39 @@
+/******************************************************************************
+* File Name: check.h
+*
+* Version 1.0
+*
+* Description:
+* This file contains the assertion macros of the host tests. A failed check
+* prints where and why and is counted; a test program returns
+* CHECK_RESULT() so make stops on the first failing binary.
+*
+*******************************************************************************/
+
+#if !defined(CHECK_H)
+#define CHECK_H
+
+#include <stdio.h>
+
+/* Number of failed checks, defined once by each test program */
+extern unsigned int checkFailures;
+
+#define CHECK_DEFINE_FAILURES       unsigned int checkFailures = 0u
+
+#define CHECK(condition, ...)       do { \
+                                        if(!(condition)) \
+                                        { \
+                                            checkFailures++; \
+                                            printf("%s:%d: FAIL: ", __FILE__, __LINE__); \
+                                            printf(__VA_ARGS__); \
+                                            printf("\n"); \
+                                        } \
+                                    } while(0)
+
+#define CHECK_RESULT(name)          ((0u == checkFailures) ? \
+                                        (printf("%s: PASS\n", (name)), 0) : \
+                                        (printf("%s: %u check(s) failed\n", (name), checkFailures), 1))
+
+#endif /* CHECK_H */
+
+/* [] END OF FILE */
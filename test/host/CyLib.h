@@ -0,0 +1,27 @@
+/******************************************************************************
+* File Name: CyLib.h
+*
+* Version 1.0
+*
+* Description:
+* This file contains the host versions of the CyLib delay and critical
+* section functions used by the Character LCD component. The delays advance
+* the time of the HD44780 model instead of waiting (lcd_model.c).
+*
+*******************************************************************************/
+
+#if !defined(CY_BOOT_CYLIB_H)
+#define CY_BOOT_CYLIB_H
+
+#include "cytypes.h"
+
+void CyDelay(uint32 milliseconds);
+void CyDelayUs(uint16 microseconds);
+void CyDelayCycles(uint32 cycles);
+
+uint8 CyEnterCriticalSection(void);
+void CyExitCriticalSection(uint8 savedIntrStatus);
+
+#endif /* CY_BOOT_CYLIB_H */
+
+/* [] END OF FILE */
@@ -0,0 +1,27 @@
+/******************************************************************************
+* File Name: cyfitter.h
+*
+* Version 1.0
+*
+* Description:
+* This file contains the host version of the generated fitter header. The
+* LCD control register is the port of the HD44780 model (lcd_model.c), so
+* every store the component makes reaches the model.
+*
+*******************************************************************************/
+
+#if !defined(INCLUDED_CYFITTER_H)
+#define INCLUDED_CYFITTER_H
+
+#include "cytypes.h"
+
+/* Bus clock of the CY8CKIT-059 project */
+#define BCLK__BUS_CLK__HZ                           (24000000u)
+
+reg8 * LcdModel_Port(void);
+
+#define LCD_Cntl_Port_Sync_ctrl_reg__CONTROL_REG    (LcdModel_Port())
+
+#endif /* INCLUDED_CYFITTER_H */
+
+/* [] END OF FILE */
@@ -0,0 +1,37 @@
+/******************************************************************************
+* File Name: cytypes.h
+*
+* Version 1.0
+*
+* Description:
+* This file contains the host version of the PSoC Creator type header, with
+* just what the Character LCD component needs to compile on a PC.
+*
+*******************************************************************************/
+
+#if !defined(CY_BOOT_CYTYPES_H)
+#define CY_BOOT_CYTYPES_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef uint8_t             uint8;
+typedef uint16_t            uint16;
+typedef uint32_t            uint32;
+typedef uint64_t            uint64;
+typedef int8_t              int8;
+typedef int16_t             int16;
+typedef int32_t             int32;
+typedef int64_t             int64;
+typedef char                char8;
+
+typedef volatile uint8      reg8;
+
+#define CYCODE
+
+/* Device family: PSoC 5LP */
+#define CY_PSOC5A           (0u)
+
+#endif /* CY_BOOT_CYTYPES_H */
+
+/* [] END OF FILE */
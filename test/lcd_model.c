@@ -0,0 +1,545 @@
+/******************************************************************************
+* File Name: lcd_model.c
+*
+* Version 1.0
+*
+* Description:
+* This file contains the HD44780 model of the host LCD tests and the host
+* versions of the CyLib delays, which advance the model time.
+*
+* The component writes the control register through
+* LCD_Cntl_Port_Sync_ctrl_reg__CONTROL_REG, which the host cyfitter.h maps
+* to LcdModel_Port(). Each call first commits the value stored by the
+* previous one, at the current model time, and then hands out the register
+* again. The delays commit before they add their time, so every store is
+* seen at the time the component made it.
+*
+*******************************************************************************/
+
+#include <string.h>
+#include "lcd_model.h"
+#include "CyLib.h"
+#include "cyfitter.h"
+
+/* Control register as last stored, and as seen by the model */
+static reg8 portSlot = 0u;
+static uint8 portValue = 0u;
+
+static uint64 nowNs = 0u;
+static uint64 busyUntilNs = 0u;
+
+/* Interface state */
+static uint8 fourBit = 0u;
+static uint8 highNibble = 0u;
+static uint8 highPending = 0u;
+static uint8 initCount = 0u;
+
+/* Controller state */
+static uint8 ddram[128u];
+static uint8 cgram[64u];
+static uint8 address = 0u;
+static uint8 inCgram = 0u;
+static uint8 increment = 1u;
+static uint8 displayOn = 0u;
+
+static LCD_MODEL_NIBBLE nibbleLog[LCD_MODEL_LOG_SIZE];
+static uint32 logCount = 0u;
+static uint32 violations = 0u;
+
+static void LcdModel_Sync(void);
+static void LcdModel_Latch(uint8 rs, uint8 nibble);
+static void LcdModel_Execute(uint8 rs, uint8 value);
+static void LcdModel_Step(void);
+
+
+/*******************************************************************************
+* Function Name: LcdModel_Reset
+********************************************************************************
+*
+* Summary:
+*  Powers the model up at time 0: 8-bit interface, display off, busy for
+*  LCD_MODEL_POWER_UP_NS. Clears the log.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void LcdModel_Reset(void)
+{
+    portSlot = 0u;
+    portValue = 0u;
+    nowNs = 0u;
+    busyUntilNs = LCD_MODEL_POWER_UP_NS;
+    fourBit = 0u;
+    highPending = 0u;
+    initCount = 0u;
+    (void) memset(ddram, ' ', sizeof(ddram));
+    (void) memset(cgram, 0, sizeof(cgram));
+    address = 0u;
+    inCgram = 0u;
+    increment = 1u;
+    displayOn = 0u;
+    logCount = 0u;
+    violations = 0u;
+}
+
+
+/*******************************************************************************
+* Function Name: LcdModel_Port
+********************************************************************************
+*
+* Summary:
+*  Commits the last store and returns the control register.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  Control register.
+*
+*******************************************************************************/
+reg8 * LcdModel_Port(void)
+{
+    LcdModel_Sync();
+
+    return &portSlot;
+}
+
+
+/*******************************************************************************
+* Function Name: LcdModel_Advance
+********************************************************************************
+*
+* Summary:
+*  Commits the last store and lets time pass.
+*
+* Parameters:
+*  ns:  time to add
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void LcdModel_Advance(uint64 ns)
+{
+    LcdModel_Sync();
+    nowNs += ns;
+}
+
+
+/*******************************************************************************
+* Function Name: LcdModel_Now
+********************************************************************************
+*
+* Summary:
+*  Returns the model time.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  Time since LcdModel_Reset() (in ns).
+*
+*******************************************************************************/
+uint64 LcdModel_Now(void)
+{
+    return nowNs;
+}
+
+
+/*******************************************************************************
+* Function Name: LcdModel_GetLog
+********************************************************************************
+*
+* Summary:
+*  Returns the nibbles latched since the last reset or ClearLog().
+*
+* Parameters:
+*  log:  receives the first entry
+*
+* Return:
+*  Number of entries.
+*
+*******************************************************************************/
+uint32 LcdModel_GetLog(LCD_MODEL_NIBBLE const ** log)
+{
+    LcdModel_Sync();
+    *log = nibbleLog;
+
+    return logCount;
+}
+
+
+/*******************************************************************************
+* Function Name: LcdModel_ClearLog
+********************************************************************************
+*
+* Summary:
+*  Empties the nibble log.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void LcdModel_ClearLog(void)
+{
+    LcdModel_Sync();
+    logCount = 0u;
+}
+
+
+/*******************************************************************************
+* Function Name: LcdModel_GetViolations
+********************************************************************************
+*
+* Summary:
+*  Returns the number of writes made while the controller was busy, and
+*  of nibbles lost to a full log.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  Number of violations.
+*
+*******************************************************************************/
+uint32 LcdModel_GetViolations(void)
+{
+    LcdModel_Sync();
+
+    return violations;
+}
+
+
+/*******************************************************************************
+* Function Name: LcdModel_GetCell
+********************************************************************************
+*
+* Summary:
+*  Returns the character code shown in a cell.
+*
+* Parameters:
+*  row:     0 .. LCD_MODEL_ROWS - 1
+*  column:  0 .. LCD_MODEL_COLUMNS - 1
+*
+* Return:
+*  DDRAM contents.
+*
+*******************************************************************************/
+uint8 LcdModel_GetCell(uint8 row, uint8 column)
+{
+    LcdModel_Sync();
+
+    return ddram[(row * 0x40u) + column];
+}
+
+
+/*******************************************************************************
+* Function Name: LcdModel_GetCgram
+********************************************************************************
+*
+* Summary:
+*  Returns the 64 bytes of character generator RAM.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  CGRAM contents.
+*
+*******************************************************************************/
+uint8 const * LcdModel_GetCgram(void)
+{
+    LcdModel_Sync();
+
+    return cgram;
+}
+
+
+/*******************************************************************************
+* Function Name: LcdModel_IsDisplayOn
+********************************************************************************
+*
+* Summary:
+*  Returns the D bit of the last display control instruction.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  Non-zero when the display is on.
+*
+*******************************************************************************/
+uint8 LcdModel_IsDisplayOn(void)
+{
+    LcdModel_Sync();
+
+    return displayOn;
+}
+
+
+/*******************************************************************************
+* Function Name: LcdModel_Is4Bit
+********************************************************************************
+*
+* Summary:
+*  Returns whether the interface has been switched to 4 bits.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  Non-zero in 4-bit mode.
+*
+*******************************************************************************/
+uint8 LcdModel_Is4Bit(void)
+{
+    LcdModel_Sync();
+
+    return fourBit;
+}
+
+
+/*******************************************************************************
+* Function Name: LcdModel_Sync
+********************************************************************************
+*
+* Summary:
+*  Takes the register value stored last; a falling edge of E latches the
+*  data nibble and RS as they were while E was high.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+static void LcdModel_Sync(void)
+{
+    uint8 value = portSlot;
+
+    if(value != portValue)
+    {
+        if((0u != (portValue & LCD_MODEL_E)) && (0u == (value & LCD_MODEL_E)))
+        {
+            LcdModel_Latch((0u != (portValue & LCD_MODEL_RS)) ? 1u : 0u, portValue & LCD_MODEL_DATA_MASK);
+        }
+
+        portValue = value;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: LcdModel_Latch
+********************************************************************************
+*
+* Summary:
+*  Logs a nibble and assembles it into an instruction or data byte.
+*
+* Parameters:
+*  rs:      register select
+*  nibble:  D7..D4
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+static void LcdModel_Latch(uint8 rs, uint8 nibble)
+{
+    if(logCount < LCD_MODEL_LOG_SIZE)
+    {
+        nibbleLog[logCount].timeNs = nowNs;
+        nibbleLog[logCount].rs = rs;
+        nibbleLog[logCount].nibble = nibble;
+        logCount++;
+    }
+    else
+    {
+        violations++;
+    }
+
+    if(0u == fourBit)
+    {
+        /* 8-bit interface: D3..D0 are not connected and read as 0 */
+        LcdModel_Execute(rs, (uint8)(nibble << 4u));
+    }
+    else if(0u == highPending)
+    {
+        highNibble = nibble;
+        highPending = 1u;
+    }
+    else
+    {
+        highPending = 0u;
+        LcdModel_Execute(rs, (uint8)((highNibble << 4u) | nibble));
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: LcdModel_Execute
+********************************************************************************
+*
+* Summary:
+*  Executes one instruction or data write.
+*
+* Parameters:
+*  rs:     register select
+*  value:  instruction or data byte
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+static void LcdModel_Execute(uint8 rs, uint8 value)
+{
+    uint64 execution = LCD_MODEL_COMMAND_NS;
+
+    if(nowNs < busyUntilNs)
+    {
+        violations++;
+    }
+
+    if(0u != rs)
+    {
+        if(0u != inCgram)
+        {
+            cgram[address & 0x3Fu] = value;
+            address = (uint8)((address + ((0u != increment) ? 1u : 0x3Fu)) & 0x3Fu);
+        }
+        else
+        {
+            ddram[address & 0x7Fu] = value;
+            LcdModel_Step();
+        }
+        execution = LCD_MODEL_DATA_NS;
+    }
+    else if(0u != (value & 0x80u))
+    {
+        address = value & 0x7Fu;
+        inCgram = 0u;
+    }
+    else if(0u != (value & 0x40u))
+    {
+        address = value & 0x3Fu;
+        inCgram = 1u;
+    }
+    else if(0u != (value & 0x20u))
+    {
+        /* Function set, DL selects the interface width */
+        if(0u == fourBit)
+        {
+            execution = (0u == initCount) ? LCD_MODEL_FIRST_INIT_NS :
+                        ((1u == initCount) ? LCD_MODEL_SECOND_INIT_NS : LCD_MODEL_COMMAND_NS);
+            initCount = (initCount < 2u) ? (initCount + 1u) : initCount;
+        }
+        fourBit = (0u == (value & 0x10u)) ? 1u : 0u;
+    }
+    else if(0u != (value & 0x10u))
+    {
+        /* Cursor or display shift, only the cursor is modelled */
+        if(0u == (value & 0x08u))
+        {
+            address = (uint8)(address + ((0u != (value & 0x04u)) ? 1u : 0x7Fu)) & 0x7Fu;
+        }
+    }
+    else if(0u != (value & 0x08u))
+    {
+        displayOn = (0u != (value & 0x04u)) ? 1u : 0u;
+    }
+    else if(0u != (value & 0x04u))
+    {
+        increment = (0u != (value & 0x02u)) ? 1u : 0u;
+    }
+    else if(0u != (value & 0x02u))
+    {
+        /* Return home */
+        address = 0u;
+        inCgram = 0u;
+        execution = LCD_MODEL_CLEAR_NS;
+    }
+    else if(0u != (value & 0x01u))
+    {
+        (void) memset(ddram, ' ', sizeof(ddram));
+        address = 0u;
+        inCgram = 0u;
+        increment = 1u;
+        execution = LCD_MODEL_CLEAR_NS;
+    }
+    else
+    {
+        /* 0x00 is not an instruction */
+        violations++;
+    }
+
+    busyUntilNs = nowNs + execution;
+}
+
+
+/*******************************************************************************
+* Function Name: LcdModel_Step
+********************************************************************************
+*
+* Summary:
+*  Moves the DDRAM address counter after a data write. In two-line mode the
+*  lines are 0x00-0x27 and 0x40-0x67 and the counter wraps from one to the
+*  other.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+static void LcdModel_Step(void)
+{
+    if(0u != increment)
+    {
+        address = (0x27u == address) ? 0x40u : ((0x67u == address) ? 0x00u : (address + 1u));
+    }
+    else
+    {
+        address = (0x40u == address) ? 0x27u : ((0x00u == address) ? 0x67u : (address - 1u));
+    }
+}
+
+
+/***************************************
+*       Host CyLib functions
+***************************************/
+
+void CyDelay(uint32 milliseconds)
+{
+    LcdModel_Advance((uint64) milliseconds * 1000000u);
+}
+
+void CyDelayUs(uint16 microseconds)
+{
+    LcdModel_Advance((uint64) microseconds * 1000u);
+}
+
+void CyDelayCycles(uint32 cycles)
+{
+    LcdModel_Advance(((uint64) cycles * 1000000000u) / BCLK__BUS_CLK__HZ);
+}
+
+uint8 CyEnterCriticalSection(void)
+{
+    return 0u;
+}
+
+void CyExitCriticalSection(uint8 savedIntrStatus)
+{
+    (void) savedIntrStatus;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,71 @@
+/******************************************************************************
+* File Name: lcd_model.h
+*
+* Version 1.0
+*
+* Description:
+* This file contains the constants and function prototypes of the HD44780
+* model the host LCD tests run the Character LCD component against. The
+* model sees every store to the LCD control register, latches a nibble on
+* each falling edge of E, and decodes them the way the controller does:
+* 8-bit interface after power-up, 4-bit after the matching function set,
+* DDRAM and CGRAM writes through the address counter. Each nibble is
+* logged with its time, and every instruction or data write that arrives
+* while the previous one is still executing counts as a violation.
+*
+*******************************************************************************/
+
+#if !defined(LCD_MODEL_H)
+#define LCD_MODEL_H
+
+#include "cytypes.h"
+
+/* Control port layout of the CharLCDmp schematic */
+#define LCD_MODEL_DATA_MASK         (0x0Fu)
+#define LCD_MODEL_E                 (0x10u)
+#define LCD_MODEL_RS                (0x20u)
+
+/* Execution times (in ns) */
+#define LCD_MODEL_POWER_UP_NS       (40000000u)
+#define LCD_MODEL_FIRST_INIT_NS     (4100000u)
+#define LCD_MODEL_SECOND_INIT_NS    (100000u)
+#define LCD_MODEL_CLEAR_NS          (1520000u)
+#define LCD_MODEL_COMMAND_NS        (37000u)
+#define LCD_MODEL_DATA_NS           (41000u)
+
+/* Nibbles kept in the log */
+#define LCD_MODEL_LOG_SIZE          (4096u)
+
+/* Visible geometry */
+#define LCD_MODEL_ROWS              (2u)
+#define LCD_MODEL_COLUMNS           (16u)
+
+/* One latched nibble */
+typedef struct
+{
+    uint64 timeNs;      /* falling edge of E */
+    uint8 rs;           /* 0: instruction, 1: data */
+    uint8 nibble;       /* D7..D4 */
+} LCD_MODEL_NIBBLE;
+
+
+/***************************************
+*        Function Prototypes
+***************************************/
+
+void LcdModel_Reset(void);
+void LcdModel_Advance(uint64 ns);
+uint64 LcdModel_Now(void);
+
+uint32 LcdModel_GetLog(LCD_MODEL_NIBBLE const ** log);
+void LcdModel_ClearLog(void);
+uint32 LcdModel_GetViolations(void);
+
+uint8 LcdModel_GetCell(uint8 row, uint8 column);
+uint8 const * LcdModel_GetCgram(void);
+uint8 LcdModel_IsDisplayOn(void);
+uint8 LcdModel_Is4Bit(void);
+
+#endif /* LCD_MODEL_H */
+
+/* [] END OF FILE */
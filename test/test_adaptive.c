@@ -0,0 +1,127 @@
+/******************************************************************************
+* File Name: test_adaptive.c
+*
+* Version 1.0
+*
+* Description:
+* This file contains the host test of the adaptive filter's step response.
+* The input jumps by one note (from one note center to the next) after the
+* filter has settled on noise, many times over:
+*
+*  - the first sample after the jump brings the output half way, to the
+*    quantizer's decision point, within FA_FIRST_SAMPLE_SLACK counts;
+*  - the remaining distance at least halves with every following sample,
+*    so after FA_SETTLE_SAMPLES it is below FA_MAX_SETTLE_ERROR of the step;
+*  - the core chain (Core_Run(), trace.c) shows the new note after
+*    FA_MAX_NOTE_LATENCY samples, and never before the jump.
+*
+* The settled noise is checked against the boxcar by the adaptive build of
+* test_filter.
+*
+*******************************************************************************/
+
+#include <math.h>
+#include "check.h"
+#include "trace.h"
+#include "filter.h"
+#include "scale.h"
+
+#if(FILTER_TYPE != FILTER_TYPE_ADAPTIVE)
+    #error "test_adaptive needs FILTER_TYPE_ADAPTIVE"
+#endif /* FILTER_TYPE != FILTER_TYPE_ADAPTIVE */
+
+/* Jumps replayed */
+#define FA_JUMPS                    (2000u)
+
+/* Noisy samples before each jump */
+#define FA_PREFILL_SAMPLES          (600u)
+
+/* Output after the first sample may fall short of half way by this much
+* (in counts): the accumulator is truncated, plus the filtered noise.
+*/
+#define FA_FIRST_SAMPLE_SLACK       (TRACE_NOISE_COUNTS)
+
+/* Remaining error (as a fraction of the step) after FA_SETTLE_SAMPLES */
+#define FA_SETTLE_SAMPLES           (6u)
+#define FA_MAX_SETTLE_ERROR         (0.04)
+
+/* Samples until the output note follows; the hysteresis needs the input
+* HYSTERESIS_WINDOW past the decision point.
+*/
+#define FA_MAX_NOTE_LATENCY         (2u)
+
+CHECK_DEFINE_FAILURES;
+
+
+int main(void)
+{
+    double step = TRACE_COUNTS_PER_VOLT / (double) NUMBER_NOTES_PER_VOLT;
+    double worstFirst = 0.0;
+    double worstSettle = 0.0;
+    double error;
+    uint32 worstLatency = 0u;
+    uint32 latency;
+    uint32 note;
+    uint32 jump;
+    uint32 i;
+    int32 from;
+    int32 to;
+    int32 average = 0;
+    int32 sample;
+    int moved;
+
+    Trace_Seed(2024u);
+
+    for(jump = 0u; jump < FA_JUMPS; jump++)
+    {
+        /* One note up or down, anywhere in the range */
+        note = 1u + Trace_Random(NUMBER_NOTE_PERFECT_STEPS - 1u);
+        from = Trace_Counts(Trace_NoteCenter(note), 0);
+        to = Trace_Counts(Trace_NoteCenter((0u != (jump & 1u)) ? (note + 1u) : (note - 1u)), 0);
+
+        Core_Start(SCALE_CHROMATIC, from);
+
+        for(i = 0u; i < FA_PREFILL_SAMPLES; i++)
+        {
+            sample = from + Trace_Noise(TRACE_NOISE_COUNTS);
+            CHECK(note == Core_Run(&sample, 1u), "note %u moved before the jump", (unsigned) note);
+        }
+
+        latency = 0u;
+        moved = 0;
+        for(i = 1u; i <= FA_SETTLE_SAMPLES; i++)
+        {
+            sample = to + Trace_Noise(TRACE_NOISE_COUNTS);
+            moved = (note != Core_Run(&sample, 1u));
+            average = Filter_GetAverage(TRACE_CHANNEL);
+
+            if(1u == i)
+            {
+                error = ((double)(to - from) / 2.0) - (average - from);
+                error = (to > from) ? error : -error;
+                worstFirst = (error > worstFirst) ? error : worstFirst;
+            }
+
+            if(moved && (0u == latency))
+            {
+                latency = i;
+            }
+        }
+
+        latency = (0u == latency) ? (FA_SETTLE_SAMPLES + 1u) : latency;
+        error = fabs((double)(average - to)) / step;
+        worstSettle = (error > worstSettle) ? error : worstSettle;
+        worstLatency = (latency > worstLatency) ? latency : worstLatency;
+    }
+
+    printf("first sample short of half way by %.0f counts, %.2f%% of a step left after %u samples, "
+           "note after %u samples\n", worstFirst, 100.0 * worstSettle, (unsigned) FA_SETTLE_SAMPLES,
+           (unsigned) worstLatency);
+    CHECK(worstFirst <= FA_FIRST_SAMPLE_SLACK, "first sample %.0f counts short of half way", worstFirst);
+    CHECK(worstSettle <= FA_MAX_SETTLE_ERROR, "%.2f%% of a step left", 100.0 * worstSettle);
+    CHECK(worstLatency <= FA_MAX_NOTE_LATENCY, "note after %u samples", (unsigned) worstLatency);
+
+    return CHECK_RESULT("test_adaptive");
+}
+
+/* [] END OF FILE */
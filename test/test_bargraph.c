@@ -0,0 +1,196 @@
+/******************************************************************************
+* File Name: test_bargraph.c
+*
+* Version 1.0
+*
+* Description:
+* This file contains the host test of the incremental bar graphs. It is
+* built for the horizontal and for the vertical bar graph character set
+* and runs the generated component against the HD44780 model:
+*
+*  - a bar graph is set up with InitHorizontalBG() or InitVerticalBG()
+*    next to some text, and the display is brought up in the background;
+*  - BG_MOVES random moves, small and large, are each made with the Update
+*    function, flushed and clocked out with FlushTick();
+*  - the glass must then be identical to a full blocking redraw with
+*    DrawHorizontalBG() or DrawVerticalBG(), text included, and a move of
+*    less than one cell must not cost more than BG_MAX_SMALL_WRITES data
+*    writes.
+*
+*******************************************************************************/
+
+#include "check.h"
+#include "trace.h"
+#include "lcd_model.h"
+#include "LCD.h"
+
+#if(LCD_CUSTOM_CHAR_SET == LCD_HORIZONTAL_BG)
+    #define BG_ROW                  (1u)
+    #define BG_COLUMN               (4u)
+    #define BG_CELLS                (8u)
+    #define BG_PIXELS_PER_CELL      (LCD_CHARACTER_WIDTH)
+    #define BG_Init(graph)          LCD_InitHorizontalBG((graph), BG_ROW, BG_COLUMN, BG_CELLS)
+    #define BG_Update(graph, value) LCD_UpdateHorizontalBG((graph), (value))
+    #define BG_Draw(value)          LCD_DrawHorizontalBG(BG_ROW, BG_COLUMN, BG_CELLS, (value))
+#elif(LCD_CUSTOM_CHAR_SET == LCD_VERTICAL_BG)
+    #define BG_ROW                  (1u)
+    #define BG_COLUMN               (13u)
+    #define BG_CELLS                (2u)
+    #define BG_PIXELS_PER_CELL      (LCD_CHARACTER_HEIGHT)
+    #define BG_Init(graph)          LCD_InitVerticalBG((graph), BG_ROW, BG_COLUMN, BG_CELLS)
+    #define BG_Update(graph, value) LCD_UpdateVerticalBG((graph), (value))
+    #define BG_Draw(value)          LCD_DrawVerticalBG(BG_ROW, BG_COLUMN, BG_CELLS, (value))
+#else
+    #error "test_bargraph needs a bar graph character set"
+#endif /* LCD_CUSTOM_CHAR_SET */
+
+#define BG_PIXELS                   (BG_CELLS * BG_PIXELS_PER_CELL)
+
+/* Number of moves, and largest value tried (past the end of the graph) */
+#define BG_MOVES                    (20000u)
+#define BG_MAX_VALUE                (BG_PIXELS + 3u)
+
+/* Data writes allowed for a move of less than one cell */
+#define BG_MAX_SMALL_WRITES         (2u)
+
+/* Ticks allowed for one flush */
+#define BG_MAX_TICKS                (20000u)
+
+#define BG_TICK_NS                  ((uint64) LCD_FLUSH_TICK_US * 1000u)
+
+CHECK_DEFINE_FAILURES;
+
+static LCD_BAR_GRAPH_STRUCT graph;
+
+
+/*******************************************************************************
+* Function Name: Bg_FlushAll
+********************************************************************************
+*
+* Summary:
+*  Flushes the frame buffer and ticks until the flush is done.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  Number of data bytes written to the model.
+*
+*******************************************************************************/
+static uint32 Bg_FlushAll(void)
+{
+    LCD_MODEL_NIBBLE const * log;
+    uint32 count;
+    uint32 writes = 0u;
+    uint32 ticks;
+    uint32 i;
+
+    LcdModel_ClearLog();
+    LCD_Flush();
+
+    for(ticks = 0u; (ticks < BG_MAX_TICKS) && (0u != LCD_IsFlushing()); ticks++)
+    {
+        LcdModel_Advance(BG_TICK_NS);
+        LCD_FlushTick();
+    }
+
+    CHECK(0u == LCD_IsFlushing(), "still flushing after %u ticks", (unsigned) ticks);
+
+    count = LcdModel_GetLog(&log);
+    for(i = 0u; i < count; i++)
+    {
+        writes += log[i].rs;
+    }
+
+    return writes / 2u;
+}
+
+
+int main(void)
+{
+    uint8 glass[LCD_MODEL_ROWS][LCD_MODEL_COLUMNS];
+    uint8 value = 0u;
+    uint8 previous;
+    uint8 row;
+    uint8 column;
+    uint8 same;
+    uint32 move;
+    uint32 writes;
+    uint32 worstSmall = 0u;
+    uint32 mismatches = 0u;
+    int32 step;
+
+    LcdModel_Reset();
+    LCD_StartBackground();
+    LCD_BufPosition(0u, 0u);
+    LCD_BufPrintString("NotePerfect  Chr");
+    LCD_BufPosition(1u, 0u);
+    LCD_BufPrintString("In:");
+    BG_Init(&graph);
+    (void) Bg_FlushAll();
+
+    Trace_Seed(21u);
+
+    for(move = 0u; move < BG_MOVES; move++)
+    {
+        previous = (value > BG_PIXELS) ? BG_PIXELS : value;
+
+        if(0u != (move & 1u))
+        {
+            value = (uint8) Trace_Random(BG_MAX_VALUE + 1u);
+        }
+        else
+        {
+            /* Less than one cell either way */
+            step = (int32) previous + (int32) Trace_Random(2u * BG_PIXELS_PER_CELL - 1u) - (BG_PIXELS_PER_CELL - 1);
+            value = (uint8)((step < 0) ? 0 : ((step > (int32) BG_PIXELS) ? (int32) BG_PIXELS : step));
+        }
+
+        BG_Update(&graph, value);
+        writes = Bg_FlushAll();
+
+        if((0u == (move & 1u)) && (previous != value))
+        {
+            worstSmall = (writes > worstSmall) ? writes : worstSmall;
+        }
+
+        for(row = 0u; row < LCD_MODEL_ROWS; row++)
+        {
+            for(column = 0u; column < LCD_MODEL_COLUMNS; column++)
+            {
+                glass[row][column] = LcdModel_GetCell(row, column);
+            }
+        }
+
+        BG_Draw(value);
+
+        same = 1u;
+        for(row = 0u; row < LCD_MODEL_ROWS; row++)
+        {
+            for(column = 0u; column < LCD_MODEL_COLUMNS; column++)
+            {
+                same = (glass[row][column] == LcdModel_GetCell(row, column)) ? same : 0u;
+            }
+        }
+
+        if(0u == same)
+        {
+            mismatches++;
+            if(mismatches <= 10u)
+            {
+                printf("move %u: %u -> %u pixels differs from a full redraw\n", (unsigned) move,
+                       (unsigned) previous, (unsigned) value);
+            }
+        }
+    }
+
+    printf("charset %u: %u moves, %u differ from a full redraw, small moves write up to %u cells\n",
+           (unsigned) LCD_CUSTOM_CHAR_SET, (unsigned) BG_MOVES, (unsigned) mismatches, (unsigned) worstSmall);
+    CHECK(0u == mismatches, "%u moves differ from a full redraw", (unsigned) mismatches);
+    CHECK(worstSmall <= BG_MAX_SMALL_WRITES, "a small move wrote %u cells", (unsigned) worstSmall);
+    CHECK(0u == LcdModel_GetViolations(), "%u writes while busy", (unsigned) LcdModel_GetViolations());
+
+    return CHECK_RESULT("test_bargraph");
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,234 @@
+/******************************************************************************
+* File Name: test_filter.c
+*
+* Version 1.0
+*
+* Description:
+* This file contains the host test of the ADC filter stage. It is built
+* once per FILTER_TYPE (see the Makefile) and checks for the type compiled
+* in:
+*
+*  - DC gain: a constant input settles to within FT_MAX_DC_ERROR counts;
+*  - SIGNAL_SLOPE: a jump past it resets the filter (the adaptive type
+*    speeds up instead), a smaller one does not;
+*  - noise: with +/-TRACE_NOISE_COUNTS input noise the settled output rms
+*    is no worse than FT_MAX_NOISE_RATIO times that of a MAX_SAMPLE boxcar
+*    run on the same samples;
+*  - Filter_ProcessBlock() gives the same result as Filter_Process() in a
+*    loop.
+*
+*******************************************************************************/
+
+#include <math.h>
+#include <stdlib.h>
+#include "check.h"
+#include "trace.h"
+#include "filter.h"
+
+/* Largest settled error on a noise-free DC input (in counts) */
+#define FT_MAX_DC_ERROR             (1)
+
+/* DC level the tests run around (in counts, about 2.9 V) */
+#define FT_DC_LEVEL                 (500000)
+
+/* Samples to settle, and samples the noise is measured over */
+#define FT_SETTLE_SAMPLES           (2048u)
+#define FT_NOISE_SAMPLES            (65536u)
+
+/* Allowed output noise relative to the boxcar. The CIC impulse response is
+* about a quarter of the boxcar length, so it passes about twice the noise.
+*/
+#if(FILTER_TYPE == FILTER_TYPE_CIC)
+    #define FT_MAX_NOISE_RATIO      (2.2)
+#else
+    #define FT_MAX_NOISE_RATIO      (1.05)
+#endif /* FILTER_TYPE == FILTER_TYPE_CIC */
+
+#define FT_CHANNEL                  (0u)
+
+CHECK_DEFINE_FAILURES;
+
+
+/*******************************************************************************
+* Function Name: Ft_DcGain
+********************************************************************************
+*
+* Summary:
+*  Settles the filter on DC levels above and below its seed.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+static void Ft_DcGain(void)
+{
+    static int32 const offsets[] = {SIGNAL_SLOPE / 2, -(SIGNAL_SLOPE / 2), 1, -1, 37, -37};
+    int32 average = 0;
+    uint32 i;
+    uint32 n;
+
+    for(n = 0u; n < (sizeof(offsets) / sizeof(offsets[0])); n++)
+    {
+        Filter_Init(FT_CHANNEL, FT_DC_LEVEL);
+
+        for(i = 0u; i < FT_SETTLE_SAMPLES; i++)
+        {
+            average = Filter_Process(FT_CHANNEL, FT_DC_LEVEL + offsets[n]);
+        }
+
+        CHECK(abs(average - (FT_DC_LEVEL + offsets[n])) <= FT_MAX_DC_ERROR,
+              "DC %+d: settled at %+d", (int) offsets[n], (int)(average - FT_DC_LEVEL));
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: Ft_Slope
+********************************************************************************
+*
+* Summary:
+*  Checks the reaction to jumps just past and just short of SIGNAL_SLOPE.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+static void Ft_Slope(void)
+{
+    int32 const jump = SIGNAL_SLOPE + 1;
+    int32 average;
+
+    Filter_Init(FT_CHANNEL, FT_DC_LEVEL);
+    average = Filter_Process(FT_CHANNEL, FT_DC_LEVEL + jump);
+
+#if(FILTER_TYPE == FILTER_TYPE_ADAPTIVE)
+    CHECK(average >= (FT_DC_LEVEL + (jump / 2)), "jump of %d: moved %d", (int) jump, (int)(average - FT_DC_LEVEL));
+#else
+    CHECK(average == (FT_DC_LEVEL + jump), "jump of %d: no reset, moved %d", (int) jump,
+          (int)(average - FT_DC_LEVEL));
+#endif /* FILTER_TYPE == FILTER_TYPE_ADAPTIVE */
+
+    Filter_Init(FT_CHANNEL, FT_DC_LEVEL);
+    average = Filter_Process(FT_CHANNEL, FT_DC_LEVEL + SIGNAL_SLOPE);
+    CHECK(average < (FT_DC_LEVEL + SIGNAL_SLOPE), "jump of %d: reset", (int) SIGNAL_SLOPE);
+}
+
+
+/*******************************************************************************
+* Function Name: Ft_Noise
+********************************************************************************
+*
+* Summary:
+*  Measures the output noise of the filter and of a reference boxcar.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+static void Ft_Noise(void)
+{
+    static int32 window[MAX_SAMPLE];
+    int32 boxcarSum = FT_DC_LEVEL << DIV;
+    double filterSquares = 0.0;
+    double boxcarSquares = 0.0;
+    double filterRms;
+    double boxcarRms;
+    int32 average;
+    int32 sample;
+    uint32 i;
+
+    for(i = 0u; i < MAX_SAMPLE; i++)
+    {
+        window[i] = FT_DC_LEVEL;
+    }
+
+    Trace_Seed(12345u);
+    Filter_Init(FT_CHANNEL, FT_DC_LEVEL);
+
+    for(i = 0u; i < (FT_SETTLE_SAMPLES + FT_NOISE_SAMPLES); i++)
+    {
+        sample = FT_DC_LEVEL + Trace_Noise(TRACE_NOISE_COUNTS);
+        average = Filter_Process(FT_CHANNEL, sample);
+
+        boxcarSum += sample - window[i % MAX_SAMPLE];
+        window[i % MAX_SAMPLE] = sample;
+
+        if(i >= FT_SETTLE_SAMPLES)
+        {
+            filterSquares += (double)(average - FT_DC_LEVEL) * (average - FT_DC_LEVEL);
+            boxcarSquares += (double)((boxcarSum >> DIV) - FT_DC_LEVEL) * ((boxcarSum >> DIV) - FT_DC_LEVEL);
+        }
+    }
+
+    filterRms = sqrt(filterSquares / FT_NOISE_SAMPLES);
+    boxcarRms = sqrt(boxcarSquares / FT_NOISE_SAMPLES);
+
+    printf("filter type %u: noise %.1f counts rms, boxcar %.1f\n", (unsigned) FILTER_TYPE, filterRms, boxcarRms);
+    CHECK(filterRms <= (boxcarRms * FT_MAX_NOISE_RATIO), "noise %.1f vs boxcar %.1f counts rms", filterRms, boxcarRms);
+}
+
+
+/*******************************************************************************
+* Function Name: Ft_Block
+********************************************************************************
+*
+* Summary:
+*  Compares Filter_ProcessBlock() with one Filter_Process() call per sample.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+static void Ft_Block(void)
+{
+    int32 samples[8u];
+    int32 single = 0;
+    int32 block;
+    uint32 n;
+    uint8 i;
+
+    Trace_Seed(99u);
+    for(n = 0u; n < 1000u; n++)
+    {
+        for(i = 0u; i < 8u; i++)
+        {
+            samples[i] = FT_DC_LEVEL + (int32)(Trace_Random(4u * SIGNAL_SLOPE)) + Trace_Noise(TRACE_NOISE_COUNTS);
+        }
+
+        Filter_Init(0u, FT_DC_LEVEL);
+        for(i = 0u; i < 8u; i++)
+        {
+            single = Filter_Process(0u, samples[i]);
+        }
+
+        Filter_Init(1u, FT_DC_LEVEL);
+        block = Filter_ProcessBlock(1u, samples, 8u);
+
+        CHECK(single == block, "block %d vs single %d", (int) block, (int) single);
+    }
+}
+
+
+int main(void)
+{
+    Ft_DcGain();
+    Ft_Slope();
+    Ft_Noise();
+    Ft_Block();
+
+    return CHECK_RESULT("test_filter");
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,208 @@
+/******************************************************************************
+* File Name: test_lcd.c
+*
+* Version 1.0
+*
+* Description:
+* This file contains the host test of the background LCD initialization.
+* The generated Character LCD component (see the Makefile) runs against the
+* HD44780 model of lcd_model.c:
+*
+*  1. Init() is run as the reference and its nibbles are logged.
+*  2. After a model reset, StartBackground() is called, the frame buffer is
+*     written and flushed at once, and FlushTick() is called every
+*     FLUSH_TICK_US until IsFlushing() returns zero.
+*
+* The background run must send the same nibbles as Init(), up to the last
+* custom font byte, each after at least the same delay as in Init(). Init()
+* then moves the address counter back to DDRAM, the background run does so
+* with its first frame buffer write. Both runs must leave the controller in
+* the same state, without a single write while it is busy, and the frame
+* buffer must be on the glass within LT_MAX_FIRST_FRAME_MS.
+*
+*******************************************************************************/
+
+#include <string.h>
+#include "check.h"
+#include "lcd_model.h"
+#include "LCD.h"
+
+/* Latest time the first frame may be complete */
+#define LT_MAX_FIRST_FRAME_MS       (140u)
+
+/* Background run is abandoned after this many ticks */
+#define LT_MAX_TICKS                (20000u)
+
+/* Timing differences below this are the E pulse and setup cycles */
+#define LT_SLACK_NS                 (1000u)
+
+#define LT_TICK_NS                  ((uint64) LCD_FLUSH_TICK_US * 1000u)
+
+CHECK_DEFINE_FAILURES;
+
+static char8 const * const frame[LCD_MODEL_ROWS] = {"NotePerfect  Chr", "0.000V  C3  2500"};
+
+static LCD_MODEL_NIBBLE reference[LCD_MODEL_LOG_SIZE];
+static uint32 referenceCount;
+static uint8 referenceCgram[64u];
+
+
+/*******************************************************************************
+* Function Name: Lt_FrameShown
+********************************************************************************
+*
+* Summary:
+*  Compares the model's DDRAM with the frame.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  Non-zero when every cell shows the frame.
+*
+*******************************************************************************/
+static uint8 Lt_FrameShown(void)
+{
+    uint8 row;
+    uint8 column;
+
+    for(row = 0u; row < LCD_MODEL_ROWS; row++)
+    {
+        for(column = 0u; column < LCD_MODEL_COLUMNS; column++)
+        {
+            if(LcdModel_GetCell(row, column) != (uint8) frame[row][column])
+            {
+                return 0u;
+            }
+        }
+    }
+
+    return 1u;
+}
+
+
+/*******************************************************************************
+* Function Name: Lt_Reference
+********************************************************************************
+*
+* Summary:
+*  Runs the blocking Init() and keeps its log.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+static void Lt_Reference(void)
+{
+    LCD_MODEL_NIBBLE const * log;
+
+    LcdModel_Reset();
+    LCD_Init();
+
+    referenceCount = LcdModel_GetLog(&log);
+    (void) memcpy(reference, log, referenceCount * sizeof(reference[0]));
+    (void) memcpy(referenceCgram, LcdModel_GetCgram(), sizeof(referenceCgram));
+
+    CHECK(0u == LcdModel_GetViolations(), "Init(): %u writes while busy", (unsigned) LcdModel_GetViolations());
+    CHECK(0u != LcdModel_IsDisplayOn(), "Init(): display off");
+    CHECK(0u != LcdModel_Is4Bit(), "Init(): still in 8-bit mode");
+
+#if(LCD_CUSTOM_CHAR_SET != LCD_NONE)
+    CHECK(0 == memcmp(referenceCgram, LCD_customFonts, sizeof(referenceCgram)), "Init(): fonts not loaded");
+
+    /* Drop the final Set DDRAM Address, see the file header */
+    CHECK((referenceCount >= 2u) && (0u == reference[referenceCount - 2u].rs) &&
+          ((LCD_DDRAM_0 >> 4u) == reference[referenceCount - 2u].nibble),
+          "Init(): does not end with Set DDRAM Address");
+    referenceCount -= 2u;
+#endif /* LCD_CUSTOM_CHAR_SET != LCD_NONE */
+}
+
+
+/*******************************************************************************
+* Function Name: Lt_Background
+********************************************************************************
+*
+* Summary:
+*  Runs StartBackground() and the tick against the reference.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+static void Lt_Background(void)
+{
+    LCD_MODEL_NIBBLE const * log;
+    uint64 frameNs = 0u;
+    uint64 gap;
+    uint64 referenceGap;
+    uint32 count;
+    uint32 ticks;
+    uint32 i;
+    uint8 row;
+
+    LcdModel_Reset();
+    LCD_StartBackground();
+
+    for(row = 0u; row < LCD_MODEL_ROWS; row++)
+    {
+        LCD_BufPosition(row, 0u);
+        LCD_BufPrintString(frame[row]);
+    }
+    LCD_Flush();
+
+    for(ticks = 0u; (ticks < LT_MAX_TICKS) && (0u != LCD_IsFlushing()); ticks++)
+    {
+        LcdModel_Advance(LT_TICK_NS);
+        LCD_FlushTick();
+
+        if((0u == frameNs) && (0u != Lt_FrameShown()))
+        {
+            frameNs = LcdModel_Now();
+        }
+    }
+
+    CHECK(0u == LCD_IsFlushing(), "still flushing after %u ticks", (unsigned) ticks);
+    CHECK(0u == LcdModel_GetViolations(), "%u writes while busy", (unsigned) LcdModel_GetViolations());
+    CHECK(0u != LcdModel_IsDisplayOn(), "display off");
+    CHECK(0u != LcdModel_Is4Bit(), "still in 8-bit mode");
+    CHECK(0 == memcmp(referenceCgram, LcdModel_GetCgram(), sizeof(referenceCgram)), "CGRAM differs from Init()");
+    CHECK(0u != Lt_FrameShown(), "frame buffer not on the glass");
+
+    count = LcdModel_GetLog(&log);
+    CHECK(count >= referenceCount, "%u nibbles, Init() sends %u", (unsigned) count, (unsigned) referenceCount);
+
+    for(i = 0u; (i < count) && (i < referenceCount); i++)
+    {
+        CHECK((log[i].rs == reference[i].rs) && (log[i].nibble == reference[i].nibble),
+              "nibble %u: rs %u %X, Init() rs %u %X", (unsigned) i, log[i].rs, log[i].nibble,
+              reference[i].rs, reference[i].nibble);
+
+        gap = log[i].timeNs - ((0u == i) ? 0u : log[i - 1u].timeNs);
+        referenceGap = reference[i].timeNs - ((0u == i) ? 0u : reference[i - 1u].timeNs);
+        CHECK((gap + LT_SLACK_NS) >= referenceGap, "nibble %u: %.1f us after the previous one, Init() waits %.1f us",
+              (unsigned) i, gap / 1000.0, referenceGap / 1000.0);
+    }
+
+    printf("charset %u: %u init nibbles, frame shown at %.1f ms, idle at %.1f ms\n", (unsigned) LCD_CUSTOM_CHAR_SET,
+           (unsigned) referenceCount, frameNs / 1e6, LcdModel_Now() / 1e6);
+    CHECK((0u != frameNs) && (frameNs <= ((uint64) LT_MAX_FIRST_FRAME_MS * 1000000u)),
+          "frame shown at %.1f ms", frameNs / 1e6);
+}
+
+
+int main(void)
+{
+    Lt_Reference();
+    Lt_Background();
+
+    return CHECK_RESULT("test_lcd");
+}
+
+/* [] END OF FILE */
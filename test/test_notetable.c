@@ -0,0 +1,61 @@
+/******************************************************************************
+* File Name: test_notetable.c
+*
+* Version 1.0
+*
+* Description:
+* This file contains the host test of the compile-time note tables. For
+* every one of the NOTE_TABLE_SIZE entries:
+*
+*  - PWM_FineLookup rounded to a whole count, the way Output_WriteFine()
+*    does without OUTPUT_DITHER, must equal PWM_Lookup;
+*  - PWM_FineLookup must be within half a fine count of the exact compare
+*    value, and PWM_Lookup within half a count;
+*  - both tables must be monotonic and end on full scale.
+*
+*******************************************************************************/
+
+#include <math.h>
+#include "check.h"
+#include "notetable.h"
+
+#define NT_FINE_SCALE               ((double)(1u << NOTE_FINE_BITS))
+
+CHECK_DEFINE_FAILURES;
+
+
+int main(void)
+{
+    double exact;
+    uint32 rounded;
+    uint32 n;
+
+    for(n = 0u; n < NOTE_TABLE_SIZE; n++)
+    {
+        rounded = (PWM_FineLookup[n] + (1u << (NOTE_FINE_BITS - 1u))) >> NOTE_FINE_BITS;
+        CHECK(rounded == PWM_Lookup[n], "entry %u: fine %u rounds to %u, PWM_Lookup %u", (unsigned) n,
+              (unsigned) PWM_FineLookup[n], (unsigned) rounded, (unsigned) PWM_Lookup[n]);
+
+        exact = (n < NUMBER_NOTE_PERFECT_STEPS) ?
+                (((double) n * MAX_CONTROL_VOLTAGE * PWM_COUNTS_PER_VOLT) / NUMBER_NOTE_PERFECT_STEPS) :
+                (double)(MAX_CONTROL_VOLTAGE * PWM_COUNTS_PER_VOLT);
+
+        CHECK(fabs((PWM_FineLookup[n] / NT_FINE_SCALE) - exact) <= (0.5 / NT_FINE_SCALE),
+              "entry %u: fine %.4f, exact %.4f", (unsigned) n, PWM_FineLookup[n] / NT_FINE_SCALE, exact);
+        CHECK(fabs(PWM_Lookup[n] - exact) <= 0.5, "entry %u: %u, exact %.4f", (unsigned) n,
+              (unsigned) PWM_Lookup[n], exact);
+
+        if(n > 0u)
+        {
+            CHECK((PWM_Lookup[n] >= PWM_Lookup[n - 1u]) && (PWM_FineLookup[n] >= PWM_FineLookup[n - 1u]),
+                  "entry %u: not monotonic", (unsigned) n);
+        }
+    }
+
+    CHECK(PWM_Lookup[NUMBER_NOTE_PERFECT_STEPS] == (MAX_CONTROL_VOLTAGE * PWM_COUNTS_PER_VOLT),
+          "last step %u", (unsigned) PWM_Lookup[NUMBER_NOTE_PERFECT_STEPS]);
+
+    return CHECK_RESULT("test_notetable");
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,176 @@
+/******************************************************************************
+* File Name: test_quantizer.c
+*
+* Version 1.0
+*
+* Description:
+* This file contains the host test of the fixed-point quantizer. Every
+* count of the 20-bit ADC range, and a coarse sweep of a few other ADC
+* scalings, is quantized with Quantizer_Quantize() and compared with exact
+* rational rounding:
+*
+*  - the step must be the exact nearest step, except for inputs within
+*    QT_TIE_TOLERANCE() of a midpoint, where either neighbour is accepted;
+*  - the returned error must match the exact step fraction to within
+*    QT_MAX_ERROR_FRACTION of a step;
+*  - below 0 V and above full scale the step clamps and the error
+*    saturates.
+*
+*******************************************************************************/
+
+#include <math.h>
+#include "check.h"
+#include "quantizer.h"
+
+/* Largest difference between the returned and the exact error (in steps) */
+#define QT_MAX_ERROR_FRACTION       (1.0e-4)
+
+/* Distance from a midpoint (in steps) within which rounding either way is
+* accepted: the reciprocal is rounded to 2^-32, so it is off by up to 2^-33
+* steps per count of input.
+*/
+#define QT_TIE_TOLERANCE(input)     ((fabs((double)(input)) + 1.0) / 8589934592.0)
+
+/* Nominal 20-bit scaling, 0 .. 6.144 V */
+#define QT_COUNTS_PER_VOLT          (170667)
+#define QT_COUNTS_MAX               ((1 << 20) - 1)
+
+/* Readings below 0 V that are swept */
+#define QT_COUNTS_MIN               (-(1 << 12))
+
+CHECK_DEFINE_FAILURES;
+
+
+/*******************************************************************************
+* Function Name: Qt_Sweep
+********************************************************************************
+*
+* Summary:
+*  Quantizes counts from first to last and compares with exact rounding.
+*
+* Parameters:
+*  countsPerVolt:  ADC scaling
+*  offset:         ADC counts at 0 V
+*  first:          first reading
+*  last:           last reading
+*  stride:         distance between two readings
+*  worstError:     updated with the largest error difference (in steps)
+*
+* Return:
+*  Number of readings with a wrong step.
+*
+*******************************************************************************/
+static uint32 Qt_Sweep(int32 countsPerVolt, int32 offset, int32 first, int32 last, int32 stride,
+                       double * worstError)
+{
+    uint64 countsFullScale = (uint64) countsPerVolt * MAX_CONTROL_VOLTAGE;
+    uint32 wrong = 0u;
+    uint32 step;
+    uint32 exact;
+    int32 counts;
+    int32 error;
+    double position;
+    double difference;
+
+    Quantizer_Init(countsPerVolt, offset);
+
+    for(counts = first; counts <= last; counts += stride)
+    {
+        step = Quantizer_Quantize(counts, &error);
+        position = ((double)(counts - offset) * NUMBER_NOTE_PERFECT_STEPS) / (double) countsFullScale;
+
+        if(position < 0.0)
+        {
+            exact = 0u;
+        }
+        else if(position > NUMBER_NOTE_PERFECT_STEPS)
+        {
+            exact = NUMBER_NOTE_PERFECT_STEPS;
+        }
+        else
+        {
+            exact = (uint32) floor(position + 0.5);
+        }
+
+        if(step != exact)
+        {
+            if(fabs(position - (floor(position) + 0.5)) > QT_TIE_TOLERANCE(counts - offset))
+            {
+                wrong++;
+            }
+        }
+        else if((position >= -0.5) && (position <= (NUMBER_NOTE_PERFECT_STEPS + 0.5)))
+        {
+            difference = fabs(((double) error / 4294967296.0) - (position - exact));
+            *worstError = (difference > *worstError) ? difference : *worstError;
+        }
+        else
+        {
+            /* Clamped, checked by Qt_Limits() */
+        }
+    }
+
+    return wrong;
+}
+
+
+/*******************************************************************************
+* Function Name: Qt_Limits
+********************************************************************************
+*
+* Summary:
+*  Checks the clamping below 0 V and above full scale.
+*
+* Parameters:
+*  None.
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+static void Qt_Limits(void)
+{
+    uint32 step;
+    int32 error;
+
+    Quantizer_Init(QT_COUNTS_PER_VOLT, 0);
+
+    step = Quantizer_Quantize(-QT_COUNTS_MAX, &error);
+    CHECK((0u == step) && (error == (int32) QUANTIZER_HALF_STEP), "far below 0 V: step %u error %d",
+          (unsigned) step, (int) error);
+
+    step = Quantizer_Quantize(-1, &error);
+    CHECK((0u == step) && (error < 0), "just below 0 V: step %u error %d", (unsigned) step, (int) error);
+
+    step = Quantizer_Quantize(QT_COUNTS_MAX, &error);
+    CHECK((NUMBER_NOTE_PERFECT_STEPS == step) && (error == (int32)(QUANTIZER_HALF_STEP - 1u)),
+          "above full scale: step %u error %d", (unsigned) step, (int) error);
+}
+
+
+int main(void)
+{
+    double worstError = 0.0;
+    uint32 wrong;
+
+    /* Every reading of the nominal 20-bit configuration */
+    wrong = Qt_Sweep(QT_COUNTS_PER_VOLT, 0, QT_COUNTS_MIN, QT_COUNTS_MAX, 1, &worstError);
+    CHECK(0u == wrong, "20-bit sweep: %u wrong steps", (unsigned) wrong);
+
+    /* Calibrated gains and offsets, and the lower resolution profiles */
+    wrong = Qt_Sweep(QT_COUNTS_PER_VOLT + 1234, -517, QT_COUNTS_MIN, QT_COUNTS_MAX, 7, &worstError);
+    CHECK(0u == wrong, "offset sweep: %u wrong steps", (unsigned) wrong);
+    wrong = Qt_Sweep(42667, 3, QT_COUNTS_MIN, (1 << 18) - 1, 1, &worstError);
+    CHECK(0u == wrong, "18-bit sweep: %u wrong steps", (unsigned) wrong);
+    wrong = Qt_Sweep(10667, 0, QT_COUNTS_MIN, (1 << 16) - 1, 1, &worstError);
+    CHECK(0u == wrong, "16-bit sweep: %u wrong steps", (unsigned) wrong);
+
+    printf("worst error difference %.3g steps\n", worstError);
+    CHECK(worstError < QT_MAX_ERROR_FRACTION, "error differs by %.3g steps", worstError);
+
+    Qt_Limits();
+
+    return CHECK_RESULT("test_quantizer");
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,186 @@
+/******************************************************************************
+* File Name: test_stats.c
+*
+* Version 1.0
+*
+* Description:
+* This file contains the host test of the correction statistics. Known
+* corrections are fed to Stats_Record() through the quantizer error, the
+* way the quantize task reports them, and checked for:
+*
+*  - the cents conversion: output minus input, rounded to the nearest cent
+*    on both sides of zero, including whole steps moved by the scale snap;
+*  - the bin of each correction, with corrections past STATS_RANGE_CENTS
+*    counted in the two outer bins;
+*  - the mean and the largest correction;
+*  - the halving of bins, sum and count at STATS_WINDOW samples, and the
+*    independence of the channels.
+*
+*******************************************************************************/
+
+#include <math.h>
+#include <stdlib.h>
+#include "check.h"
+#include "stats.h"
+
+#if((STATS_BINS != 16u) || (STATS_BIN_CENTS != 6) || (NUMBER_NOTES_PER_VOLT != 12u))
+    #error "The expected bins below assume 16 bins of 6 cents and 100 cents per step"
+#endif /* bins of the expected values */
+
+/* Step the inputs are next to, well inside the note range */
+#define TS_STEP                     (24u)
+
+CHECK_DEFINE_FAILURES;
+
+/* Quantizer error of an input inputCents above its nearest step */
+static int32 Ts_Error(double inputCents)
+{
+    return (int32) lround((inputCents / STATS_CENTS_PER_STEP) * 4294967296.0);
+}
+
+/* Records one sample whose input is inputCents above TS_STEP and whose
+* output is moved by noteSteps from it
+*/
+static void Ts_Record(uint8 channel, double inputCents, int32 noteSteps)
+{
+    Stats_Record(channel, (uint32)((int32) TS_STEP + noteSteps), TS_STEP, Ts_Error(inputCents));
+}
+
+/* Bin that went up by one from before to after, -1 if none or several */
+static int Ts_Counted(Stats_HISTOGRAM const * before, Stats_HISTOGRAM const * after)
+{
+    int bin;
+    int found = -1;
+
+    for(bin = 0; bin < (int) STATS_BINS; bin++)
+    {
+        if(after->bins[bin] != before->bins[bin])
+        {
+            if((found >= 0) || (after->bins[bin] != (before->bins[bin] + 1u)))
+            {
+                return -1;
+            }
+            found = bin;
+        }
+    }
+
+    return found;
+}
+
+/* One correction and where it must be counted */
+typedef struct
+{
+    double inputCents;      /* input above the step */
+    int32 noteSteps;        /* output note minus the step */
+    int32 cents;            /* expected correction */
+    int bin;                /* expected bin */
+} Ts_CASE;
+
+static Ts_CASE const Ts_Cases[] =
+{
+    {   0.0,  0,    0,  8 },
+    {  25.0,  0,  -25,  3 },
+    { -25.0,  0,   25, 12 },
+    {  10.4,  0,  -10,  6 },    /* rounded to the nearest cent, both ways */
+    {  10.6,  0,  -11,  6 },
+    { -10.4,  0,   10,  9 },
+    { -10.6,  0,   11,  9 },
+    {   0.4,  0,    0,  8 },
+    {  -0.4,  0,    0,  8 },
+    { -47.0,  0,   47, 15 },    /* last cents inside the range */
+    {  48.0,  0,  -48,  0 },
+    { -48.0,  0,   48, 15 },    /* first past it, clamped */
+    {  49.0,  0,  -49,  0 },
+    {   0.0,  1,  100, 15 },    /* whole steps moved by the scale */
+    {   0.0, -1, -100,  0 },
+    {  30.0,  1,   70, 15 },
+    { -30.0, -1,  -70,  0 },
+    {  40.0,  1,   60, 15 },
+};
+
+#define TS_CASES                    (sizeof(Ts_Cases) / sizeof(Ts_Cases[0]))
+
+
+int main(void)
+{
+    Stats_HISTOGRAM histogram;
+    int32 sum = 0;
+    uint32 maxCents = 0u;
+    uint32 i;
+    int bin;
+
+    /* Cents and bin of every case, one sample each */
+    Stats_Reset();
+    for(i = 0u; i < TS_CASES; i++)
+    {
+        Stats_HISTOGRAM before;
+
+        Stats_GetHistogram(0u, &before);
+        Ts_Record(0u, Ts_Cases[i].inputCents, Ts_Cases[i].noteSteps);
+        Stats_GetHistogram(0u, &histogram);
+        bin = Ts_Counted(&before, &histogram);
+
+        CHECK(bin == Ts_Cases[i].bin, "input %+.1f cents, note %+d: bin %d, expected %d",
+              Ts_Cases[i].inputCents, (int) Ts_Cases[i].noteSteps, bin, Ts_Cases[i].bin);
+        CHECK((histogram.sum - before.sum) == Ts_Cases[i].cents, "input %+.1f cents, note %+d: %d cents, expected %d",
+              Ts_Cases[i].inputCents, (int) Ts_Cases[i].noteSteps, (int)(histogram.sum - before.sum),
+              (int) Ts_Cases[i].cents);
+
+        sum += Ts_Cases[i].cents;
+        maxCents = ((uint32) labs(Ts_Cases[i].cents) > maxCents) ? (uint32) labs(Ts_Cases[i].cents) : maxCents;
+    }
+
+    /* Mean and largest correction of the cases */
+    Stats_GetHistogram(0u, &histogram);
+    CHECK(histogram.count == TS_CASES, "count %u, expected %u", (unsigned) histogram.count, (unsigned) TS_CASES);
+    CHECK(histogram.sum == sum, "sum %d, expected %d", (int) histogram.sum, (int) sum);
+    CHECK(histogram.maxCents == maxCents, "max %u, expected %u", (unsigned) histogram.maxCents, (unsigned) maxCents);
+    CHECK(Stats_GetMean(0u) == (sum / (int32) TS_CASES), "mean %d, expected %d", (int) Stats_GetMean(0u),
+          (int)(sum / (int32) TS_CASES));
+
+    /* The other channel is untouched; a reset clears everything */
+    Stats_GetHistogram(1u, &histogram);
+    CHECK((histogram.count == 0u) && (histogram.sum == 0) && (histogram.maxCents == 0u),
+          "channel 1 changed by channel 0");
+    CHECK(Stats_GetMean(1u) == 0, "mean of an empty channel %d", (int) Stats_GetMean(1u));
+
+    Stats_Reset();
+    Stats_GetHistogram(0u, &histogram);
+    CHECK((histogram.count == 0u) && (histogram.sum == 0) && (histogram.maxCents == 0u),
+          "Stats_Reset() left count %u, sum %d, max %u", (unsigned) histogram.count, (int) histogram.sum,
+          (unsigned) histogram.maxCents);
+    for(bin = 0; bin < (int) STATS_BINS; bin++)
+    {
+        CHECK(histogram.bins[bin] == 0u, "Stats_Reset() left bin %d at %u", bin, (unsigned) histogram.bins[bin]);
+    }
+
+    /* Halving: three samples of +25 cents and the rest of the window at 0,
+     * the last sample of the window halves bins, sum and count */
+    for(i = 0u; i < 3u; i++)
+    {
+        Ts_Record(1u, -25.0, 0);
+    }
+    for(i = 3u; i < (STATS_WINDOW - 1u); i++)
+    {
+        Ts_Record(1u, 0.0, 0);
+    }
+    Stats_GetHistogram(1u, &histogram);
+    CHECK((histogram.count == (STATS_WINDOW - 1u)) && (histogram.bins[8] == (STATS_WINDOW - 4u)) &&
+          (histogram.bins[12] == 3u) && (histogram.sum == 75), "before the window: count %u, bins %u/%u, sum %d",
+          (unsigned) histogram.count, (unsigned) histogram.bins[8], (unsigned) histogram.bins[12],
+          (int) histogram.sum);
+
+    Ts_Record(1u, 0.0, 0);
+    Stats_GetHistogram(1u, &histogram);
+    CHECK(histogram.count == (STATS_WINDOW / 2u), "after the window: count %u, expected %u",
+          (unsigned) histogram.count, (unsigned)(STATS_WINDOW / 2u));
+    CHECK(histogram.bins[8] == ((STATS_WINDOW - 3u) / 2u), "after the window: bin 8 %u, expected %u",
+          (unsigned) histogram.bins[8], (unsigned)((STATS_WINDOW - 3u) / 2u));
+    CHECK(histogram.bins[12] == 1u, "after the window: bin 12 %u, expected 1", (unsigned) histogram.bins[12]);
+    CHECK(histogram.sum == 37, "after the window: sum %d, expected 37", (int) histogram.sum);
+    CHECK(histogram.maxCents == 25u, "after the window: max %u, expected 25", (unsigned) histogram.maxCents);
+
+    return CHECK_RESULT("test_stats");
+}
+
+/* [] END OF FILE */
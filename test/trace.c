@@ -0,0 +1,261 @@
+/******************************************************************************
+* File Name: trace.c
+*
+* Version 1.0
+*
+* Description:
+* This file contains the synthetic input traces and the core replay shared
+* by the host tests. Core_Run() is the per-batch path of the main loop:
+* Filter_ProcessBlock() -> Quantizer_Quantize() -> Scale_Snap() ->
+* Quantizer_Hold(). Trace_Expected() is the reference it is judged against:
+* the allowed note nearest to the true input, found by brute force in
+* floating point, and how far the input is from the nearest decision point.
+*
+*******************************************************************************/
+
+#include "trace.h"
+#include "filter.h"
+#include "quantizer.h"
+#include "scale.h"
+
+/* Noise generator state */
+static uint32 noiseState = 1u;
+
+
+/*******************************************************************************
+* Function Name: Trace_Seed
+********************************************************************************
+*
+* Summary:
+*  Restarts the xorshift noise generator, so every run sees the same noise.
+*
+* Parameters:
+*  seed:  any non-zero value
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void Trace_Seed(uint32 seed)
+{
+    noiseState = (0u == seed) ? 1u : seed;
+}
+
+
+/*******************************************************************************
+* Function Name: Trace_Noise
+********************************************************************************
+*
+* Summary:
+*  Returns triangular noise (sum of two uniform draws) between about
+*  -peak and +peak.
+*
+* Parameters:
+*  peak:  largest magnitude, 0 for no noise
+*
+* Return:
+*  Noise sample.
+*
+*******************************************************************************/
+int32 Trace_Noise(int32 peak)
+{
+    int32 sum = 0;
+    uint8 i;
+
+    if(peak <= 0)
+    {
+        return 0;
+    }
+
+    for(i = 0u; i < 2u; i++)
+    {
+        sum += (int32) Trace_Random((uint32) peak + 1u) - (peak / 2);
+    }
+
+    return sum;
+}
+
+
+/*******************************************************************************
+* Function Name: Trace_Random
+********************************************************************************
+*
+* Summary:
+*  Returns a uniform draw of the noise generator.
+*
+* Parameters:
+*  range:  number of possible values
+*
+* Return:
+*  0 .. range - 1.
+*
+*******************************************************************************/
+uint32 Trace_Random(uint32 range)
+{
+    noiseState ^= noiseState << 13;
+    noiseState ^= noiseState >> 17;
+    noiseState ^= noiseState << 5;
+
+    return noiseState % range;
+}
+
+
+/*******************************************************************************
+* Function Name: Trace_Counts
+********************************************************************************
+*
+* Summary:
+*  Converts an input voltage to ADC counts and adds noise.
+*
+* Parameters:
+*  microvolts:  true input
+*  noisePeak:   peak noise in counts
+*
+* Return:
+*  ADC counts.
+*
+*******************************************************************************/
+int32 Trace_Counts(double microvolts, int32 noisePeak)
+{
+    double counts = (microvolts * TRACE_COUNTS_PER_VOLT) / 1000000.0;
+
+    return (int32)((counts < 0.0) ? (counts - 0.5) : (counts + 0.5)) + TRACE_OFFSET + Trace_Noise(noisePeak);
+}
+
+
+/*******************************************************************************
+* Function Name: Trace_NoteCenter
+********************************************************************************
+*
+* Summary:
+*  Returns the voltage of a step.
+*
+* Parameters:
+*  note:  step number
+*
+* Return:
+*  Step voltage in uV.
+*
+*******************************************************************************/
+double Trace_NoteCenter(uint32 note)
+{
+    return (double) note * TRACE_STEP_UV;
+}
+
+
+/*******************************************************************************
+* Function Name: Trace_Expected
+********************************************************************************
+*
+* Summary:
+*  Finds the allowed step nearest to a voltage, searching every step.
+*
+* Parameters:
+*  microvolts:  true input
+*  mask:        NUMBER_NOTES_PER_VOLT bit note mask of the scale
+*  margin:      receives the distance (in uV) from the input to the nearest
+*               point where the answer changes, i.e. half way between the
+*               result and the next nearest allowed step
+*
+* Return:
+*  Nearest allowed step.
+*
+*******************************************************************************/
+uint32 Trace_Expected(double microvolts, uint32 mask, double * margin)
+{
+    uint32 note;
+    uint32 best = 0u;
+    double bestDistance = 1e30;
+    double nextDistance = 1e30;
+    double distance;
+
+    for(note = 0u; note <= NUMBER_NOTE_PERFECT_STEPS; note++)
+    {
+        if(0u == (mask & (1uL << (note % NUMBER_NOTES_PER_VOLT))))
+        {
+            continue;
+        }
+
+        distance = microvolts - Trace_NoteCenter(note);
+        distance = (distance < 0.0) ? -distance : distance;
+
+        if(distance < bestDistance)
+        {
+            nextDistance = bestDistance;
+            bestDistance = distance;
+            best = note;
+        }
+        else if(distance < nextDistance)
+        {
+            nextDistance = distance;
+        }
+        else
+        {
+            /* farther than both */
+        }
+    }
+
+    *margin = (nextDistance - bestDistance) / 2.0;
+
+    return best;
+}
+
+
+/*******************************************************************************
+* Function Name: Core_Start
+********************************************************************************
+*
+* Summary:
+*  Resets the core the way main() does at power-up: nominal ADC scaling, a
+*  scale, and the filter seeded with one conversion whose note is taken at
+*  once.
+*
+* Parameters:
+*  scale:   SCALE_CHROMATIC .. SCALE_COUNT - 1
+*  counts:  first conversion
+*
+* Return:
+*  None.
+*
+*******************************************************************************/
+void Core_Start(uint8 scale, int32 counts)
+{
+    uint32 step;
+    int32 error;
+
+    Quantizer_Init(TRACE_COUNTS_PER_VOLT, TRACE_OFFSET);
+    Scale_Select(scale);
+    Filter_Init(TRACE_CHANNEL, counts);
+
+    step = Quantizer_Quantize(Filter_GetAverage(TRACE_CHANNEL), &error);
+    (void) Quantizer_Hold(TRACE_CHANNEL, Scale_Snap(step, error), step, error);
+}
+
+
+/*******************************************************************************
+* Function Name: Core_Run
+********************************************************************************
+*
+* Summary:
+*  Runs one batch of conversions through the core.
+*
+* Parameters:
+*  samples:  ADC counts, oldest first
+*  count:    number of samples in the batch
+*
+* Return:
+*  Output step after the batch.
+*
+*******************************************************************************/
+uint32 Core_Run(int32 const samples[], uint8 count)
+{
+    int32 average = Filter_ProcessBlock(TRACE_CHANNEL, samples, count);
+    uint32 step;
+    int32 error;
+
+    step = Quantizer_Quantize(average, &error);
+
+    return Quantizer_Hold(TRACE_CHANNEL, Scale_Snap(step, error), step, error);
+}
+
+/* [] END OF FILE */
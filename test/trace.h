@@ -0,0 +1,50 @@
+/******************************************************************************
+* File Name: trace.h
+*
+* Version 1.0
+*
+* Description:
+* This file contains the constants and function prototypes of the synthetic
+* input traces and the core replay used by the host tests. Traces are in
+* microvolts of the true (noise-free) input; Trace_Counts() turns them into
+* ADC counts with the nominal 20-bit scaling and optional noise.
+*
+*******************************************************************************/
+
+#if !defined(TRACE_H)
+#define TRACE_H
+
+#include "hal.h"
+#include "notetable.h"
+
+/* Nominal scaling of the 20-bit ADC configuration, 0 .. 6.144 V */
+#define TRACE_COUNTS_PER_VOLT       (170667)
+#define TRACE_OFFSET                (0)
+
+/* Peak input noise (in counts), about +/-1.2 mV */
+#define TRACE_NOISE_COUNTS          (200)
+
+/* One NotePerfect step (in uV) */
+#define TRACE_STEP_UV               ((FULL_SCALE_MV * 1000.0) / NUMBER_NOTE_PERFECT_STEPS)
+
+/* Channel the traces are replayed on */
+#define TRACE_CHANNEL               (0u)
+
+
+/***************************************
+*        Function Prototypes
+***************************************/
+
+void Trace_Seed(uint32 seed);
+int32 Trace_Noise(int32 peak);
+uint32 Trace_Random(uint32 range);
+int32 Trace_Counts(double microvolts, int32 noisePeak);
+double Trace_NoteCenter(uint32 note);
+uint32 Trace_Expected(double microvolts, uint32 mask, double * margin);
+
+void Core_Start(uint8 scale, int32 counts);
+uint32 Core_Run(int32 const samples[], uint8 count);
+
+#endif /* TRACE_H */
+
+/* [] END OF FILE */